@@ -37,8 +37,15 @@
 
 
 AccessControlProvider::AccessControlProvider() :
+	AccessControlProvider(VeyonCore::networkObjectDirectoryManager().configuredDirectory())
+{
+}
+
+
+
+AccessControlProvider::AccessControlProvider(NetworkObjectDirectory* networkObjectDirectory) :
 	m_userGroupsBackend(VeyonCore::userGroupsBackendManager().configuredBackend()),
-	m_networkObjectDirectory(VeyonCore::networkObjectDirectoryManager().configuredDirectory()),
+	m_networkObjectDirectory(networkObjectDirectory),
 	m_useDomainUserGroups(VeyonCore::config().useDomainUserGroups()),
 	m_accessControlFeature(QLatin1String(staticMetaObject.className()),
 						   Feature::Flag::Meta | Feature::Flag::Builtin,
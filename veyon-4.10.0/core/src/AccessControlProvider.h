@@ -64,6 +64,7 @@ public:
 	};
 
 	AccessControlProvider();
+	explicit AccessControlProvider( NetworkObjectDirectory* networkObjectDirectory );
 
 	QStringList userGroups() const;
 	QStringList locations() const;
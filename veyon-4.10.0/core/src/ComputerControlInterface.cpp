@@ -37,7 +37,8 @@ ComputerControlInterface::ComputerControlInterface( const Computer& computer, in
 	QObject( parent ),
 	m_computer( computer ),
 	m_port(port),
-	m_computerNameSource(VeyonCore::config().computerNameSource())
+	m_computerNameSource(VeyonCore::config().computerNameSource()),
+	m_serverSideScaling(VeyonCore::config().computerMonitoringServerSideScaling())
 {
 	m_pingTimer.setInterval(ConnectionWatchdogPingDelay);
 	m_pingTimer.setSingleShot(true);
@@ -107,7 +108,7 @@ void ComputerControlInterface::start( QSize scaledFramebufferSize, UpdateMode up
 
 		setUpdateMode( updateMode );
 
-		vncConnection->start();
+		vncConnection->restart();
 	}
 	else
 	{
@@ -188,6 +189,8 @@ void ComputerControlInterface::setScaledFramebufferSize( QSize scaledFramebuffer
 	{
 		vncConnection()->setScaledSize( m_scaledFramebufferSize );
 	}
+
+	updateServerSideScaling();
 }
 
 
@@ -234,6 +237,23 @@ void ComputerControlInterface::setAccessControlFailed(const QString& details)
 
 
 
+bool ComputerControlInterface::compactFeatureMessages() const
+{
+	return m_connection && m_connection->compactFeatureMessages();
+}
+
+
+
+void ComputerControlInterface::setCompactFeatureMessages(bool enabled)
+{
+	if (m_connection)
+	{
+		m_connection->setCompactFeatureMessages(enabled);
+	}
+}
+
+
+
 void ComputerControlInterface::setServerVersion(VeyonCore::ApplicationVersion version)
 {
 	m_serverVersionQueryTimer.stop();
@@ -252,6 +272,7 @@ void ComputerControlInterface::setServerVersion(VeyonCore::ApplicationVersion ve
 		updateSessionInfo();
 		updateScreens();
 		setMinimumFramebufferUpdateInterval();
+		updateServerSideScaling();
 	}
 	else
 	{
@@ -316,11 +337,11 @@ void ComputerControlInterface::setActiveFeatures( const FeatureUidList& activeFe
 
 
 
-void ComputerControlInterface::sendFeatureMessage(const FeatureMessage& featureMessage)
+void ComputerControlInterface::sendFeatureMessage(const FeatureMessage& featureMessage, const QByteArray& rfbMessage)
 {
 	if( m_connection && m_connection->isConnected() )
 	{
-		m_connection->sendFeatureMessage(featureMessage);
+		m_connection->sendFeatureMessage(featureMessage, rfbMessage);
 	}
 }
 
@@ -340,14 +361,41 @@ bool ComputerControlInterface::isMessageQueueEmpty()
 
 void ComputerControlInterface::setUpdateMode( UpdateMode updateMode )
 {
+	const auto previousUpdateMode = m_updateMode;
+
 	m_updateMode = updateMode;
 
 	setMinimumFramebufferUpdateInterval();
 	setQuality();
+	updateServerSideScaling();
 
 	if (vncConnection())
 	{
+		// framebuffer is outdated after framebuffer updates have been suspended
+		if (previousUpdateMode == UpdateMode::FeatureControlOnly && m_updateMode != UpdateMode::FeatureControlOnly)
+		{
+			vncConnection()->requestFullFramebufferUpdate();
+		}
+
 		vncConnection()->setSkipHostPing(m_updateMode == UpdateMode::Basic || m_updateMode == UpdateMode::FeatureControlOnly);
+		// thumbnails are scaled while decoding, views requiring full resolution (e.g. Live mode)
+		// switch back to rescaling the full framebuffer on demand
+		vncConnection()->setThumbnailMode(m_updateMode == UpdateMode::Monitoring || m_updateMode == UpdateMode::Basic);
+	}
+}
+
+
+
+void ComputerControlInterface::setFramebufferUpdateIntervalLimit(int interval)
+{
+	if (m_framebufferUpdateIntervalLimit != interval)
+	{
+		m_framebufferUpdateIntervalLimit = interval;
+
+		if (m_updateMode == UpdateMode::Monitoring || m_updateMode == UpdateMode::Basic)
+		{
+			setMinimumFramebufferUpdateInterval();
+		}
 	}
 }
 
@@ -402,27 +450,27 @@ void ComputerControlInterface::setMinimumFramebufferUpdateInterval()
 	switch (m_updateMode)
 	{
 	case UpdateMode::Disabled:
-		updateInterval = UpdateIntervalDisabled;
+		updateInterval = MonitoringMode::SuspendedFramebufferUpdateInterval;
 		break;
 
 	case UpdateMode::Basic:
 	case UpdateMode::Monitoring:
-		updateInterval = VeyonCore::config().computerMonitoringUpdateInterval();
+		updateInterval = std::max(VeyonCore::config().computerMonitoringUpdateInterval(),
+								  m_framebufferUpdateIntervalLimit);
 		break;
 
 	case UpdateMode::Live:
 		break;
 
 	case UpdateMode::FeatureControlOnly:
-		if (vncConnection())
-		{
-			vncConnection()->setSkipFramebufferUpdates(true);
-		}
+		// let the server discard the update request libvncclient sends after each update
+		updateInterval = MonitoringMode::SuspendedFramebufferUpdateInterval;
 		break;
 	}
 
 	if (vncConnection())
 	{
+		vncConnection()->setSkipFramebufferUpdates(m_updateMode == UpdateMode::FeatureControlOnly);
 		vncConnection()->setFramebufferUpdateInterval(updateInterval);
 	}
 
@@ -466,6 +514,25 @@ void ComputerControlInterface::setQuality()
 
 
 
+void ComputerControlInterface::updateServerSideScaling()
+{
+	if (m_serverSideScaling == false ||
+		m_serverVersion < VeyonCore::ApplicationVersion::Version_4_7 ||
+		state() != State::Connected)
+	{
+		return;
+	}
+
+	// let the server downscale the framebuffer for thumbnails so neither bandwidth nor
+	// decoding is spent on pixels which are never displayed at full size
+	const auto scaledSize = (m_updateMode == UpdateMode::Monitoring || m_updateMode == UpdateMode::Basic) ?
+								m_scaledFramebufferSize : QSize{};
+
+	VeyonCore::builtinFeatures().monitoringMode().setScaledFramebufferSize({weakPointer()}, scaledSize);
+}
+
+
+
 void ComputerControlInterface::resetWatchdog()
 {
 	if (state() == State::Connected || state() == State::AccessControlFailed)
@@ -517,6 +584,8 @@ void ComputerControlInterface::updateServerVersion()
 
 	if (vncConnection())
 	{
+		// server might have changed after reconnecting, so stick to the regular format until it replies
+		setCompactFeatureMessages(false);
 		VeyonCore::builtinFeatures().monitoringMode().queryApplicationVersion({weakPointer()});
 		m_serverVersionQueryTimer.start();
 	}
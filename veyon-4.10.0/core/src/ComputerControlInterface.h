@@ -122,6 +122,9 @@ public:
 
 	void setServerVersion(VeyonCore::ApplicationVersion version);
 
+	bool compactFeatureMessages() const;
+	void setCompactFeatureMessages(bool enabled);
+
 	const QString& userLoginName() const
 	{
 		return m_userLoginName;
@@ -165,7 +168,7 @@ public:
 		m_designatedModeFeature = designatedModeFeature;
 	}
 
-	void sendFeatureMessage(const FeatureMessage& featureMessage);
+	void sendFeatureMessage(const FeatureMessage& featureMessage, const QByteArray& rfbMessage = {});
 	bool isMessageQueueEmpty();
 
 	void setUpdateMode( UpdateMode updateMode );
@@ -174,6 +177,13 @@ public:
 		return m_updateMode;
 	}
 
+	/** \brief Sets a lower bound for the framebuffer update interval in Monitoring and Basic mode (0 = no limit) */
+	void setFramebufferUpdateIntervalLimit(int interval);
+	int framebufferUpdateIntervalLimit() const
+	{
+		return m_framebufferUpdateIntervalLimit;
+	}
+
 	void setProperty(QUuid propertyId, const QVariant& data);
 
 	QVariant queryProperty(QUuid propertyId);
@@ -195,6 +205,7 @@ private:
 	void ping();
 	void setMinimumFramebufferUpdateInterval();
 	void setQuality();
+	void updateServerSideScaling();
 	void resetWatchdog();
 	void restartConnection();
 
@@ -210,13 +221,14 @@ private:
 	static constexpr int ConnectionWatchdogPingDelay = 10000;
 	static constexpr int ConnectionWatchdogTimeout = ConnectionWatchdogPingDelay*2;
 	static constexpr int ServerVersionQueryTimeout = 5000;
-	static constexpr int UpdateIntervalDisabled = 5000;
 
 	const Computer m_computer;
 	const int m_port;
 
 	UpdateMode m_updateMode{UpdateMode::Disabled};
+	int m_framebufferUpdateIntervalLimit{0};
 	Computer::NameSource m_computerNameSource{Computer::NameSource::Default};
+	const bool m_serverSideScaling;
 
 	State m_state{State::Disconnected};
 	QString m_userLoginName{};
@@ -24,6 +24,8 @@
 
 #include <openssl/bn.h>
 
+#include <QMessageAuthenticationCode>
+
 #include "CryptoCore.h"
 
 CryptoCore::CryptoCore() :
@@ -73,6 +75,25 @@ QByteArray CryptoCore::generateChallenge()
 
 
 
+QByteArray CryptoCore::maskData( const QByteArray& data, const QByteArray& context, const QByteArray& key )
+{
+	const auto mask = QMessageAuthenticationCode::hash( context, key, QCryptographicHash::Sha256 );
+	if( data.size() > mask.size() )
+	{
+		return {};
+	}
+
+	auto maskedData = data;
+	for( int i = 0; i < maskedData.size(); ++i )
+	{
+		maskedData[i] = char( maskedData[i] ^ mask[i] );
+	}
+
+	return maskedData;
+}
+
+
+
 QString CryptoCore::encryptPassword( const PlaintextPassword& password ) const
 {
 	return QString::fromLatin1( m_defaultPrivateKey.toPublicKey().
@@ -52,6 +52,9 @@ public:
 
 	static QByteArray generateChallenge();
 
+	// XORs data with an HMAC-SHA256 of context derived from key, i.e. masking twice restores the data
+	static QByteArray maskData( const QByteArray& data, const QByteArray& context, const QByteArray& key );
+
 	QString encryptPassword( const PlaintextPassword& password ) const;
 	PlaintextPassword decryptPassword( const QString& encryptedPassword ) const;
 
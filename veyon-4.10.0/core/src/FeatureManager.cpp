@@ -55,6 +55,11 @@ FeatureManager::FeatureManager( QObject* parent ) :
 			m_featurePluginInterfaces += featurePluginInterface;
 
 			m_features += featurePluginInterface->featureList();
+
+			for (const auto& feature : featurePluginInterface->featureList())
+			{
+				m_featureProviders[feature.uid()].append(featurePluginInterface);
+			}
 		}
 	}
 
@@ -88,7 +93,7 @@ const FeatureList& FeatureManager::features( Plugin::Uid pluginUid ) const
 
 const Feature& FeatureManager::feature( Feature::Uid featureUid ) const
 {
-	for( const auto& featureInterface : m_featurePluginInterfaces )
+	for( const auto& featureInterface : featureProviders( featureUid ) )
 	{
 		for( const auto& feature : featureInterface->featureList() )
 		{
@@ -113,7 +118,7 @@ const FeatureList& FeatureManager::relatedFeatures( Feature::Uid featureUid ) co
 
 Feature::Uid FeatureManager::metaFeatureUid( Feature::Uid featureUid ) const
 {
-	for( const auto& featureInterface : m_featurePluginInterfaces )
+	for( const auto& featureInterface : featureProviders( featureUid ) )
 	{
 		for( const auto& feature : featureInterface->featureList() )
 		{
@@ -213,7 +218,7 @@ void FeatureManager::handleFeatureMessage(ComputerControlInterface::Pointer comp
 {
 	vDebug() << computerControlInterface << message;
 
-	for( const auto& featureInterface : std::as_const( m_featurePluginInterfaces ) )
+	for( const auto& featureInterface : featureProviders( message.featureUid() ) )
 	{
 		featureInterface->handleFeatureMessage(computerControlInterface, message);
 	}
@@ -233,7 +238,7 @@ void FeatureManager::handleFeatureMessage(VeyonServerInterface& server,
 		return;
 	}
 
-	for( const auto& featureInterface : std::as_const( m_featurePluginInterfaces ) )
+	for( const auto& featureInterface : featureProviders( message.featureUid() ) )
 	{
 		featureInterface->handleFeatureMessage(server, messageContext, message);
 	}
@@ -252,7 +257,7 @@ void FeatureManager::handleFeatureMessageFromWorker(VeyonServerInterface& server
 		return;
 	}
 
-	for (const auto& featureInterface : std::as_const(m_featurePluginInterfaces))
+	for (const auto& featureInterface : featureProviders(message.featureUid()))
 	{
 		featureInterface->handleFeatureMessageFromWorker(server, message);
 	}
@@ -265,7 +270,7 @@ void FeatureManager::handleFeatureMessage(VeyonWorkerInterface& worker, const Fe
 {
 	vDebug() << "[WORKER]" << message;
 
-	for( const auto& featureInterface : std::as_const( m_featurePluginInterfaces ) )
+	for( const auto& featureInterface : featureProviders( message.featureUid() ) )
 	{
 		featureInterface->handleFeatureMessage(worker, message);
 	}
@@ -289,12 +294,14 @@ FeatureUidList FeatureManager::activeFeatures( VeyonServerInterface& server ) co
 {
 	FeatureUidList features;
 
+	const auto runningWorkers = server.featureWorkerManager().runningWorkers();
+
 	for( const auto& featureInterface : std::as_const( m_featurePluginInterfaces ) )
 	{
 		for( const auto& feature : featureInterface->featureList() )
 		{
-			if( featureInterface->isFeatureActive( server, feature.uid() ) ||
-				server.featureWorkerManager().isWorkerRunning( feature.uid() ) )
+			if( runningWorkers.contains( feature.uid() ) ||
+				featureInterface->isFeatureActive( server, feature.uid() ) )
 			{
 				features.append( feature.uid() );
 			}
@@ -303,3 +310,18 @@ FeatureUidList FeatureManager::activeFeatures( VeyonServerInterface& server ) co
 
 	return features;
 }
+
+
+
+const FeatureProviderInterfaceList& FeatureManager::featureProviders(Feature::Uid featureUid) const
+{
+	const auto it = m_featureProviders.constFind(featureUid);
+	if (it != m_featureProviders.constEnd())
+	{
+		return *it;
+	}
+
+	// feature lists of some plugins (e.g. screen selection in demo plugin) change at runtime
+	// so fall back to all plugins for features which have not been known at load time
+	return m_featurePluginInterfaces;
+}
@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <QHash>
 #include <QObject>
 
 #include "Feature.h"
@@ -83,11 +84,14 @@ public:
 	FeatureUidList activeFeatures( VeyonServerInterface& server ) const;
 
 private:
+	const FeatureProviderInterfaceList& featureProviders(Feature::Uid featureUid) const;
+
 	FeatureList m_features;
 	FeatureUidList m_disabledFeaturesUids{};
 	const FeatureList m_emptyFeatureList;
 	QObjectList m_pluginObjects;
 	FeatureProviderInterfaceList m_featurePluginInterfaces;
+	QHash<Feature::Uid, FeatureProviderInterfaceList> m_featureProviders;
 	const Feature m_dummyFeature;
 
 };
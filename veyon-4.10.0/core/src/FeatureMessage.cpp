@@ -25,6 +25,90 @@
 #include "FeatureManager.h"
 #include "FeatureMessage.h"
 #include "VariantArrayMessage.h"
+#include "VariantStream.h"
+
+#include <QBuffer>
+#include <QtEndian>
+#include <QUuid>
+
+
+// compact format: RFB message type, 32 bit message size (big endian), feature UID (16 bytes),
+// command, number of arguments and all arguments as key/type/value tuples - all integers
+// (except message size) are stored as variable-length integers (7 bits per byte, LSB first)
+
+static void appendVarInt( QByteArray& data, quint32 value )
+{
+	while( value >= 0x80 )
+	{
+		data.append( char( ( value & 0x7f ) | 0x80 ) );
+		value >>= 7;
+	}
+	data.append( char( value ) );
+}
+
+
+
+static quint32 zigZagEncode( qint32 value )
+{
+	return ( quint32( value ) << 1 ) ^ quint32( value >> 31 );
+}
+
+
+
+static qint32 zigZagDecode( quint32 value )
+{
+	return qint32( value >> 1 ) ^ -qint32( value & 1 );
+}
+
+
+
+class CompactMessageReader
+{
+public:
+	explicit CompactMessageReader( const QByteArray& data ) :
+		m_pos( data.constData() ),
+		m_end( data.constData() + data.size() )
+	{
+	}
+
+	bool readVarInt( quint32& value )
+	{
+		value = 0;
+		for( int shift = 0; shift < 35 && m_pos < m_end; shift += 7 )
+		{
+			const auto byte = quint8( *m_pos++ );
+			value |= quint32( byte & 0x7f ) << shift;
+			if( ( byte & 0x80 ) == 0 )
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	const char* readBytes( quint32 size )
+	{
+		if( quint32( m_end - m_pos ) < size )
+		{
+			return nullptr;
+		}
+
+		const auto data = m_pos;
+		m_pos += size;
+		return data;
+	}
+
+	bool atEnd() const
+	{
+		return m_pos == m_end;
+	}
+
+private:
+	const char* m_pos;
+	const char* m_end;
+
+};
 
 
 bool FeatureMessage::sendPlain(QIODevice* ioDevice) const
@@ -51,10 +135,13 @@ bool FeatureMessage::sendAsRfbMessage(QIODevice* ioDevice) const
 {
 	if (ioDevice)
 	{
-		const char rfbMessageType = FeatureMessage::RfbMessageType;
-		ioDevice->write(&rfbMessageType, sizeof(rfbMessageType));
+		VariantArrayMessage message(ioDevice);
 
-		return sendPlain(ioDevice);
+		message.write( m_featureUid );
+		message.write(CommandType(m_command));
+		message.write( m_arguments );
+
+		return message.send(QByteArray(1, char(FeatureMessage::RfbMessageType)));
 	}
 
 	vCritical() << "no IO device!";
@@ -64,6 +151,94 @@ bool FeatureMessage::sendAsRfbMessage(QIODevice* ioDevice) const
 
 
 
+QByteArray FeatureMessage::toRfbMessage() const
+{
+	QBuffer buffer;
+	buffer.open(QBuffer::WriteOnly); // Flawfinder: ignore
+
+	sendAsRfbMessage(&buffer);
+
+	return buffer.data();
+}
+
+
+
+QByteArray FeatureMessage::toCompactRfbMessage() const
+{
+	constexpr auto HeaderSize = 1 + int(sizeof(MessageSize));
+
+	QByteArray data;
+	data.reserve( HeaderSize + 32 );
+	data.append( char(CompactRfbMessageType) );
+	data.append( int(sizeof(MessageSize)), '\0' );
+
+	data.append( m_featureUid.toRfc4122() );
+	appendVarInt( data, zigZagEncode( CommandType(m_command) ) );
+	appendVarInt( data, quint32( m_arguments.size() ) );
+
+	for( auto it = m_arguments.constBegin(), end = m_arguments.constEnd(); it != end; ++it )
+	{
+		bool isNumericKey = false;
+		const auto key = it.key().toUInt( &isNumericKey );
+		if( isNumericKey == false || it.value().isValid() == false )
+		{
+			return toRfbMessage();
+		}
+
+		appendVarInt( data, key );
+
+		const auto& value = it.value();
+		switch( value.userType() )
+		{
+		case QMetaType::Bool:
+			data.append( char(CompactValueType::Bool) );
+			data.append( char( value.toBool() ) );
+			break;
+		case QMetaType::Int:
+			data.append( char(CompactValueType::Int) );
+			appendVarInt( data, zigZagEncode( value.toInt() ) );
+			break;
+		case QMetaType::QString:
+		{
+			const auto utf8 = value.toString().toUtf8();
+			data.append( char(CompactValueType::String) );
+			appendVarInt( data, quint32( utf8.size() ) );
+			data.append( utf8 );
+			break;
+		}
+		case QMetaType::QByteArray:
+		{
+			const auto byteArray = value.toByteArray();
+			data.append( char(CompactValueType::ByteArray) );
+			appendVarInt( data, quint32( byteArray.size() ) );
+			data.append( byteArray );
+			break;
+		}
+		case QMetaType::QUuid:
+			data.append( char(CompactValueType::Uuid) );
+			data.append( value.toUuid().toRfc4122() );
+			break;
+		default:
+		{
+			QBuffer buffer;
+			buffer.open( QBuffer::WriteOnly ); // Flawfinder: ignore
+			VariantStream( &buffer ).write( value );
+
+			data.append( char(CompactValueType::Variant) );
+			appendVarInt( data, quint32( buffer.data().size() ) );
+			data.append( buffer.data() );
+			break;
+		}
+		}
+	}
+
+	qToBigEndian<MessageSize>( MessageSize( data.size() - HeaderSize ), data.data() + 1 );
+
+	return data;
+}
+
+
+
 bool FeatureMessage::isReadyForReceive( QIODevice* ioDevice )
 {
 	return ioDevice != nullptr &&
@@ -98,6 +273,171 @@ bool FeatureMessage::receive( QIODevice* ioDevice )
 
 
 
+bool FeatureMessage::receiveCompact( QIODevice* ioDevice )
+{
+	if( ioDevice == nullptr )
+	{
+		vCritical() << "no IO device!";
+		return false;
+	}
+
+	MessageSize messageSize;
+	if( ioDevice->read( reinterpret_cast<char *>( &messageSize ), sizeof(messageSize) ) != sizeof(messageSize) ) // Flawfinder: ignore
+	{
+		vDebug() << "could not read message size!";
+		return false;
+	}
+
+	messageSize = qFromBigEndian(messageSize);
+	if( messageSize > MaxCompactMessageSize )
+	{
+		vDebug() << "invalid message size" << messageSize;
+		return false;
+	}
+
+	const auto data = ioDevice->read( messageSize ); // Flawfinder: ignore
+	if( data.size() != static_cast<qint64>( messageSize ) || decodeCompact( data ) == false )
+	{
+		vWarning() << "could not receive message!";
+		return false;
+	}
+
+	return true;
+}
+
+
+
+bool FeatureMessage::decodeCompact( const QByteArray& data )
+{
+	CompactMessageReader reader( data );
+
+	constexpr quint32 UuidSize = 16;
+
+	const auto featureUid = reader.readBytes( UuidSize );
+	quint32 command = 0;
+	quint32 argumentCount = 0;
+	if( featureUid == nullptr ||
+		reader.readVarInt( command ) == false ||
+		reader.readVarInt( argumentCount ) == false ||
+		argumentCount > VariantStream::MaxContainerSize )
+	{
+		return false;
+	}
+
+	Arguments arguments;
+
+	for( quint32 i = 0; i < argumentCount; ++i )
+	{
+		quint32 key = 0;
+		const char* type = nullptr;
+		if( reader.readVarInt( key ) == false ||
+			( type = reader.readBytes( 1 ) ) == nullptr )
+		{
+			return false;
+		}
+
+		QVariant value;
+		quint32 size = 0;
+
+		switch( CompactValueType( *type ) )
+		{
+		case CompactValueType::Bool:
+		{
+			const auto b = reader.readBytes( 1 );
+			if( b == nullptr )
+			{
+				return false;
+			}
+			value = *b != 0;
+			break;
+		}
+		case CompactValueType::Int:
+			if( reader.readVarInt( size ) == false )
+			{
+				return false;
+			}
+			value = zigZagDecode( size );
+			break;
+		case CompactValueType::String:
+		{
+			const char* utf8 = nullptr;
+			if( reader.readVarInt( size ) == false ||
+				size > VariantStream::MaxStringSize ||
+				( utf8 = reader.readBytes( size ) ) == nullptr )
+			{
+				return false;
+			}
+			const auto string = QString::fromUtf8( utf8, int(size) );
+			if( string.size() > VariantStream::MaxStringSize / 2 )
+			{
+				vDebug() << "string too long";
+				return false;
+			}
+			value = string;
+			break;
+		}
+		case CompactValueType::ByteArray:
+		{
+			const char* byteArray = nullptr;
+			if( reader.readVarInt( size ) == false ||
+				size > VariantStream::MaxByteArraySize ||
+				( byteArray = reader.readBytes( size ) ) == nullptr )
+			{
+				return false;
+			}
+			value = QByteArray( byteArray, int(size) );
+			break;
+		}
+		case CompactValueType::Uuid:
+		{
+			const auto uuid = reader.readBytes( UuidSize );
+			if( uuid == nullptr )
+			{
+				return false;
+			}
+			value = QUuid::fromRfc4122( QByteArray::fromRawData( uuid, UuidSize ) );
+			break;
+		}
+		case CompactValueType::Variant:
+		{
+			const char* variantData = nullptr;
+			if( reader.readVarInt( size ) == false ||
+				( variantData = reader.readBytes( size ) ) == nullptr )
+			{
+				return false;
+			}
+			auto rawData = QByteArray::fromRawData( variantData, int(size) );
+			QBuffer buffer( &rawData );
+			buffer.open( QBuffer::ReadOnly ); // Flawfinder: ignore
+			value = VariantStream( &buffer ).read(); // Flawfinder: ignore
+			if( value.isValid() == false )
+			{
+				return false;
+			}
+			break;
+		}
+		default:
+			vDebug() << "invalid value type" << int(*type);
+			return false;
+		}
+
+		arguments[QString::number( key )] = value;
+	}
+
+	if( reader.atEnd() == false )
+	{
+		return false;
+	}
+
+	m_featureUid = QUuid::fromRfc4122( QByteArray::fromRawData( featureUid, UuidSize ) );
+	m_command = Command( zigZagDecode( command ) );
+	m_arguments = arguments;
+
+	return true;
+}
+
+
+
 QDebug operator<<(QDebug stream, const FeatureMessage& message)
 {
 	stream << QStringLiteral("FeatureMessage(%1,%2,%3)")
@@ -40,6 +40,7 @@ public:
 	using Arguments = QVariantMap;
 
 	static constexpr unsigned char RfbMessageType = 41;
+	static constexpr unsigned char CompactRfbMessageType = 42;
 
 	enum class Command
 	{
@@ -134,11 +135,34 @@ public:
 	bool sendPlain(QIODevice* ioDevice) const;
 	bool sendAsRfbMessage(QIODevice* ioDevice) const;
 
+	QByteArray toRfbMessage() const;
+
+	/** \brief Encodes the message in the compact format which must only be sent to peers which announced
+	 *  support for it, falls back to the regular format for arguments with non-numeric keys */
+	QByteArray toCompactRfbMessage() const;
+
 	bool isReadyForReceive( QIODevice* ioDevice );
 
 	bool receive( QIODevice* ioDevice );
+	bool receiveCompact( QIODevice* ioDevice );
 
 private:
+	// type tags of argument values in compact messages - any other type is stored via VariantStream
+	enum class CompactValueType : quint8
+	{
+		Variant,
+		Bool,
+		Int,
+		String,
+		ByteArray,
+		Uuid
+	};
+
+	// the largest byte array accepted by VariantStream (16 MB) plus space for further arguments
+	static constexpr MessageSize MaxCompactMessageSize = 17*1024*1024;
+
+	bool decodeCompact( const QByteArray& data );
+
 	FeatureUid m_featureUid{};
 	Command m_command = Command::Invalid;
 	Arguments m_arguments{};
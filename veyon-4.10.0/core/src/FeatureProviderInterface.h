@@ -193,9 +193,28 @@ public:
 protected:
 	void sendFeatureMessage(const FeatureMessage& message, const ComputerControlInterfaceList& computerControlInterfaces)
 	{
+		// serialize once per format and share the encoded message with all connections
+		QByteArray rfbMessage;
+		QByteArray compactRfbMessage;
+
 		for (const auto& controlInterface : computerControlInterfaces)
 		{
-			controlInterface->sendFeatureMessage(message);
+			if (controlInterface->compactFeatureMessages())
+			{
+				if (compactRfbMessage.isEmpty())
+				{
+					compactRfbMessage = message.toCompactRfbMessage();
+				}
+				controlInterface->sendFeatureMessage(message, compactRfbMessage);
+			}
+			else
+			{
+				if (rfbMessage.isEmpty())
+				{
+					rfbMessage = message.toRfbMessage();
+				}
+				controlInterface->sendFeatureMessage(message, rfbMessage);
+			}
 		}
 	}
 
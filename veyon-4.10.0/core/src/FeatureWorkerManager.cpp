@@ -24,8 +24,16 @@
 
 #include <QCoreApplication>
 #include <QDir>
+#include <QFileInfo>
 #include <QThread>
 #include <QTimer>
+#include <QUuid>
+
+#ifdef Q_OS_UNIX
+#include <pwd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
 
 #include "FeatureManager.h"
 #include "FeatureWorkerManager.h"
@@ -40,34 +48,75 @@
 FeatureWorkerManager::FeatureWorkerManager( VeyonServerInterface& server, QObject* parent ) :
 	QObject( parent ),
 	m_server( server ),
-	m_tcpServer( this )
+	m_workerServer( this ),
+	m_workerPoolSize( VeyonCore::config().featureWorkerPoolSize() )
 {
-	connect( &m_tcpServer, &QTcpServer::newConnection,
+	connect( &m_workerServer, &Server::newConnection,
 			 this, &FeatureWorkerManager::acceptConnection );
 
-	if( !m_tcpServer.listen( QHostAddress::LocalHost,
-							 static_cast<quint16>( VeyonCore::config().featureWorkerManagerPort() + VeyonCore::sessionId() ) ) )
+#ifdef Q_OS_WIN
+	if( m_workerServer.listen( QHostAddress::LocalHost, serverPort() ) == false )
+	{
+		vCritical() << "can't listen on localhost" << m_workerServer.errorString();
+	}
+#else
+	// the socket is accessible for the server's user only and is handed over to the
+	// user of the current session before starting session workers
+	m_workerServer.setSocketOptions( QLocalServer::UserAccessOption );
+
+	if( prepareSocketDirectory() == false )
 	{
-		vCritical() << "can't listen on localhost!";
+		vCritical() << "can't prepare socket directory" << socketDirectory();
 	}
 
-	auto pendingMessagesTimer = new QTimer( this );
-	connect( pendingMessagesTimer, &QTimer::timeout, this, &FeatureWorkerManager::sendPendingMessages );
+	// remove stale socket file of a previous crashed instance
+	QLocalServer::removeServer( serverName() );
 
-	pendingMessagesTimer->start( 100 );
+	if( m_workerServer.listen( serverName() ) == false )
+	{
+		vCritical() << "can't listen" << m_workerServer.errorString();
+	}
+#endif
+
+	if( m_workerPoolSize > 0 )
+	{
+		// periodically check the pool as the user session might not be available yet
+		connect( &m_workerPoolTimer, &QTimer::timeout, this, &FeatureWorkerManager::fillWorkerPool );
+		m_workerPoolTimer.start( UnmanagedSessionProcessRetryInterval );
+
+		QTimer::singleShot( 0, this, &FeatureWorkerManager::fillWorkerPool );
+	}
 }
 
 
 
 FeatureWorkerManager::~FeatureWorkerManager()
 {
-	m_tcpServer.close();
+	m_workerServer.close();
 
 	// properly shutdown all worker processes
 	while( m_workers.isEmpty() == false )
 	{
 		stopWorker( m_workers.firstKey() );
 	}
+
+	// idle pool workers exit once their connection is closed
+	for( const auto& poolWorker : std::as_const( m_poolWorkers ) )
+	{
+		if( poolWorker.socket )
+		{
+			poolWorker.socket->disconnect( this );
+			poolWorker.socket->close();
+		}
+	}
+
+	for( const auto& poolWorker : std::as_const( m_startingPoolWorkers ) )
+	{
+		if( poolWorker.process )
+		{
+			poolWorker.process->terminate();
+		}
+	}
 }
 
 
@@ -82,33 +131,22 @@ bool FeatureWorkerManager::startManagedSystemWorker( Feature::Uid featureUid )
 
 	stopWorker( featureUid );
 
-	Worker worker;
-
-	worker.process = new QProcess;
-	worker.process->setProcessChannelMode( QProcess::ForwardedChannels );
-
-	connect( worker.process, static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
-			 worker.process, &QProcess::deleteLater );
-
-	vDebug() << "Starting managed system worker for feature" << VeyonCore::featureManager().feature(featureUid).name();
-	if( qEnvironmentVariableIsSet("VEYON_VALGRIND_WORKERS") )
+	if( assignPoolWorker( WorkerType::ManagedSystem, featureUid ) )
 	{
-		worker.process->start( QStringLiteral("valgrind"),
-							   { QStringLiteral("--error-limit=no"),
-								 QStringLiteral("--leak-check=full"),
-								 QStringLiteral("--show-leak-kinds=all"),
-								 QStringLiteral("--log-file=valgrind-%1.log").arg(featureUid.toString(QUuid::WithoutBraces)),
-								 VeyonCore::filesystem().workerFilePath(), featureUid.toString() } );
-	}
-	else
-	{
-		worker.process->start( VeyonCore::filesystem().workerFilePath(), { featureUid.toString() } );
+		return true;
 	}
 
+	vDebug() << "Starting managed system worker for feature" << VeyonCore::featureManager().feature(featureUid).name();
+
+	Worker worker;
+	worker.process = startWorkerProcess( { featureUid.toString() } );
+
 	m_workersMutex.lock();
 	m_workers[featureUid] = worker;
 	m_workersMutex.unlock();
 
+	Q_EMIT workersChanged();
+
 	return true;
 }
 
@@ -124,6 +162,11 @@ bool FeatureWorkerManager::startUnmanagedSessionWorker( Feature::Uid featureUid
 
 	stopWorker( featureUid );
 
+	if( assignPoolWorker( WorkerType::UnmanagedSession, featureUid ) )
+	{
+		return true;
+	}
+
 	Worker worker;
 
 	vDebug() << "Starting worker (unmanaged session process) for feature" << featureUid;
@@ -135,6 +178,8 @@ bool FeatureWorkerManager::startUnmanagedSessionWorker( Feature::Uid featureUid
 		return false;
 	}
 
+	grantSessionUserAccess( currentUser );
+
 	const auto ret = VeyonCore::platform().coreFunctions().
 					 runProgramAsUser( VeyonCore::filesystem().workerFilePath(), { featureUid.toString() },
 									   currentUser,
@@ -149,6 +194,8 @@ bool FeatureWorkerManager::startUnmanagedSessionWorker( Feature::Uid featureUid
 	m_workers[featureUid] = worker;
 	m_workersMutex.unlock();
 
+	Q_EMIT workersChanged();
+
 	return true;
 }
 
@@ -189,6 +236,10 @@ bool FeatureWorkerManager::stopWorker( Feature::Uid featureUid )
 		}
 
 		m_workers.remove( featureUid );
+
+		locker.unlock();
+
+		Q_EMIT workersChanged();
 	}
 
 	return false;
@@ -235,38 +286,121 @@ bool FeatureWorkerManager::isWorkerRunning( Feature::Uid featureUid )
 
 
 
+FeatureUidList FeatureWorkerManager::runningWorkers()
+{
+	QMutexLocker locker( &m_workersMutex );
+	return m_workers.keys();
+}
+
+
+
+#ifdef Q_OS_WIN
+quint16 FeatureWorkerManager::serverPort()
+{
+	return static_cast<quint16>( VeyonCore::config().featureWorkerManagerPort() + VeyonCore::sessionId() );
+}
+#else
+QString FeatureWorkerManager::serverName()
+{
+	// configured port still separates multiple installations and sessions - relative names
+	// resolve against the temporary directory of each process, which differs between the
+	// server and workers started in a user session on many systems
+	return QStringLiteral("%1/VeyonFeatureWorkerManager-%2").arg( socketDirectory() )
+			.arg( VeyonCore::config().featureWorkerManagerPort() + VeyonCore::sessionId() );
+}
+#endif
+
+
+
+#ifdef Q_OS_UNIX
+QString FeatureWorkerManager::socketDirectory()
+{
+	return QStringLiteral("/var/run/veyon");
+}
+
+
+
+bool FeatureWorkerManager::prepareSocketDirectory()
+{
+	const auto path = socketDirectory();
+
+	if( QDir().mkpath( path ) == false )
+	{
+		return false;
+	}
+
+	// refuse to use a directory which could have been prepared by someone else
+	if( QFileInfo( path ).ownerId() != ::geteuid() )
+	{
+		vCritical() << path << "is not owned by the server user";
+		return false;
+	}
+
+	return QFile::setPermissions( path, QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner |
+										QFile::ExeGroup | QFile::ExeOther );
+}
+#endif
+
+
+
+void FeatureWorkerManager::grantSessionUserAccess( const QString& username )
+{
+#ifdef Q_OS_UNIX
+	const auto socketPath = m_workerServer.fullServerName();
+	const auto passwordEntry = getpwnam( username.toUtf8().constData() );
+
+	if( passwordEntry == nullptr ||
+		::chown( QFile::encodeName( socketPath ).constData(), passwordEntry->pw_uid, gid_t(-1) ) != 0 )
+	{
+		vWarning() << "failed to grant user" << username << "access to" << socketPath;
+	}
+#else
+	Q_UNUSED(username)
+#endif
+}
+
+
+
 void FeatureWorkerManager::acceptConnection()
 {
 	vDebug() << "accepting connection";
 
-	QTcpSocket* socket = m_tcpServer.nextPendingConnection();
+	auto socket = m_workerServer.nextPendingConnection();
 
 	// connect to readyRead() signal of new connection
-	connect( socket, &QTcpSocket::readyRead,
+	connect( socket, &Socket::readyRead,
 			 this, [=] () { processConnection( socket ); } );
 
-	connect( socket, &QTcpSocket::disconnected,
+	connect( socket, &Socket::disconnected,
 			 this, [=] () { closeConnection( socket ); } );
 }
 
 
 
-void FeatureWorkerManager::processConnection( QTcpSocket* socket )
+void FeatureWorkerManager::processConnection( Socket* socket )
 {
 	FeatureMessage message;
 	while (message.isReadyForReceive(socket))
 	{
 		message.receive(socket);
 
+		if (message.featureUid().isNull() && message.command() == FeatureMessage::Command::Init)
+		{
+			registerPoolWorker(socket, message);
+			continue;
+		}
+
 		m_workersMutex.lock();
 
 		// set socket information
 		if (m_workers.contains(message.featureUid()))
 		{
-			if (m_workers[message.featureUid()].socket.isNull())
+			auto& worker = m_workers[message.featureUid()];
+			if (worker.socket.isNull())
 			{
-				m_workers[message.featureUid()].socket = socket;
-				sendPendingMessages();
+				// flush everything queued while the worker was starting up
+				worker.socket = socket;
+				sendPendingMessages(worker);
 			}
 
 			m_workersMutex.unlock();
@@ -287,8 +421,10 @@ void FeatureWorkerManager::processConnection( QTcpSocket* socket )
 
 
 
-void FeatureWorkerManager::closeConnection( QTcpSocket* socket )
+void FeatureWorkerManager::closeConnection( Socket* socket )
 {
+	bool workerRemoved = false;
+
 	m_workersMutex.lock();
 
 	for( auto it = m_workers.begin(); it != m_workers.end(); )
@@ -297,6 +433,7 @@ void FeatureWorkerManager::closeConnection( QTcpSocket* socket )
 		{
 			vDebug() << "removing worker after socket has been closed";
 			it = m_workers.erase( it );
+			workerRemoved = true;
 		}
 		else
 		{
@@ -306,7 +443,25 @@ void FeatureWorkerManager::closeConnection( QTcpSocket* socket )
 
 	m_workersMutex.unlock();
 
+	for( auto it = m_poolWorkers.begin(); it != m_poolWorkers.end(); )
+	{
+		if( it->socket == socket )
+		{
+			vDebug() << "removing pool worker after socket has been closed";
+			it = m_poolWorkers.erase( it );
+		}
+		else
+		{
+			++it;
+		}
+	}
+
 	socket->deleteLater();
+
+	if( workerRemoved )
+	{
+		Q_EMIT workersChanged();
+	}
 }
 
 
@@ -317,7 +472,15 @@ void FeatureWorkerManager::sendMessage( const FeatureMessage& message )
 
 	if( m_workers.contains( message.featureUid() ) )
 	{
-		m_workers[message.featureUid()].pendingMessages.append( message );
+		auto& worker = m_workers[message.featureUid()];
+		worker.pendingMessages.append( message );
+
+		// send immediately if the worker is connected already, otherwise the message
+		// is sent as soon as the worker connects
+		if( worker.socket )
+		{
+			sendPendingMessages( worker );
+		}
 	}
 	else
 	{
@@ -329,20 +492,272 @@ void FeatureWorkerManager::sendMessage( const FeatureMessage& message )
 
 
 
-void FeatureWorkerManager::sendPendingMessages()
+void FeatureWorkerManager::sendPendingMessages( Worker& worker )
 {
-	m_workersMutex.lock();
+	while( worker.socket && worker.pendingMessages.isEmpty() == false )
+	{
+		worker.pendingMessages.first().sendPlain(worker.socket);
+		worker.pendingMessages.removeFirst();
+	}
+}
+
+
+
+QProcess* FeatureWorkerManager::startWorkerProcess( const QStringList& arguments )
+{
+	auto process = new QProcess;
+	process->setProcessChannelMode( QProcess::ForwardedChannels );
+
+	connect( process, static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
+			 process, &QProcess::deleteLater );
 
-	for( auto it = m_workers.begin(); it != m_workers.end(); ++it )
+	if( qEnvironmentVariableIsSet("VEYON_VALGRIND_WORKERS") )
+	{
+		process->start( QStringLiteral("valgrind"),
+						{ QStringLiteral("--error-limit=no"),
+						  QStringLiteral("--leak-check=full"),
+						  QStringLiteral("--show-leak-kinds=all"),
+						  QStringLiteral("--log-file=valgrind-%1.log").arg(QString(arguments.first()).remove(QLatin1Char('{')).remove(QLatin1Char('}'))),
+						  VeyonCore::filesystem().workerFilePath() } + arguments );
+	}
+	else
 	{
-		auto& worker = it.value();
+		process->start( VeyonCore::filesystem().workerFilePath(), arguments );
+	}
+
+	return process;
+}
 
-		while( worker.socket && worker.pendingMessages.isEmpty() == false )
+
+
+#ifdef Q_OS_UNIX
+bool FeatureWorkerManager::isPeerUser( Socket* socket, const QString& username )
+{
+	auto expectedUid = geteuid();
+	if( username.isEmpty() == false )
+	{
+		const auto pw = getpwnam( username.toUtf8().constData() );
+		if( pw == nullptr )
 		{
-			worker.pendingMessages.first().sendPlain(worker.socket);
-			worker.pendingMessages.removeFirst();
+			return false;
 		}
+		expectedUid = pw->pw_uid;
 	}
 
-	m_workersMutex.unlock();
+	const auto fd = int( socket->socketDescriptor() );
+
+#ifdef Q_OS_LINUX
+	struct ucred credentials{};
+	socklen_t credentialsSize = sizeof(credentials);
+	if( getsockopt( fd, SOL_SOCKET, SO_PEERCRED, &credentials, &credentialsSize ) != 0 )
+	{
+		return false;
+	}
+	return credentials.uid == expectedUid;
+#else
+	uid_t uid = 0;
+	gid_t gid = 0;
+	if( getpeereid( fd, &uid, &gid ) != 0 )
+	{
+		return false;
+	}
+	return uid == expectedUid;
+#endif
+}
+#endif
+
+
+
+void FeatureWorkerManager::fillWorkerPool()
+{
+	const auto currentUser = VeyonCore::platform().userFunctions().currentUser();
+
+	discardStalePoolWorkers( currentUser );
+
+	int systemWorkers = 0;
+	int sessionWorkers = 0;
+
+	for( const auto& poolWorker : std::as_const( m_poolWorkers ) )
+	{
+		if( poolWorker.type == WorkerType::ManagedSystem )
+		{
+			++systemWorkers;
+		}
+		else
+		{
+			++sessionWorkers;
+		}
+	}
+
+	for( const auto& poolWorker : std::as_const( m_startingPoolWorkers ) )
+	{
+		if( poolWorker.type == WorkerType::ManagedSystem )
+		{
+			++systemWorkers;
+		}
+		else
+		{
+			++sessionWorkers;
+		}
+	}
+
+	while( systemWorkers < m_workerPoolSize )
+	{
+		vDebug() << "starting managed system pool worker";
+
+		const auto token = QUuid::createUuid().toString( QUuid::WithoutBraces );
+
+		// the command line of a process is visible to all users, so hand over the token through
+		// the standard input which only we have access to
+		auto process = startWorkerProcess( { poolWorkerArgument() } );
+		process->write( token.toUtf8() + '\n' );
+		process->closeWriteChannel();
+
+		auto& poolWorker = m_startingPoolWorkers[token];
+		poolWorker.type = WorkerType::ManagedSystem;
+		poolWorker.process = process;
+		poolWorker.startTimer.start();
+
+		++systemWorkers;
+	}
+
+	if( sessionWorkers >= m_workerPoolSize || currentUser.isEmpty() )
+	{
+		return;
+	}
+
+	grantSessionUserAccess( currentUser );
+
+	while( sessionWorkers < m_workerPoolSize )
+	{
+		vDebug() << "starting unmanaged session pool worker";
+
+		const auto token = QUuid::createUuid().toString( QUuid::WithoutBraces );
+
+		if( VeyonCore::platform().coreFunctions().
+			runProgramAsUser( VeyonCore::filesystem().workerFilePath(), { poolWorkerArgument(), token },
+							  currentUser,
+							  VeyonCore::platform().coreFunctions().activeDesktopName() ) == false )
+		{
+			vWarning() << "failed to start unmanaged session pool worker";
+			break;
+		}
+
+		auto& poolWorker = m_startingPoolWorkers[token];
+		poolWorker.type = WorkerType::UnmanagedSession;
+		poolWorker.username = currentUser;
+		poolWorker.startTimer.start();
+
+		++sessionWorkers;
+	}
+}
+
+
+
+void FeatureWorkerManager::discardStalePoolWorkers( const QString& currentUser )
+{
+	// session workers started for a previous user must never serve the current one
+	for( auto it = m_poolWorkers.begin(); it != m_poolWorkers.end(); )
+	{
+		if( it->socket.isNull() ||
+			( it->type == WorkerType::UnmanagedSession && it->username != currentUser ) )
+		{
+			if( it->socket )
+			{
+				vDebug() << "discarding pool worker of user" << it->username;
+				it->socket->disconnect( this );
+				it->socket->close();
+				it->socket->deleteLater();
+			}
+			it = m_poolWorkers.erase( it );
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	// processes of session workers can't be tracked so give up waiting for them after a while
+	for( auto it = m_startingPoolWorkers.begin(); it != m_startingPoolWorkers.end(); )
+	{
+		const auto stale = it->type == WorkerType::ManagedSystem ?
+							   it->process.isNull() :
+							   ( it->username != currentUser || it->startTimer.hasExpired( PoolWorkerStartTimeout ) );
+		if( stale )
+		{
+			it = m_startingPoolWorkers.erase( it );
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+
+
+void FeatureWorkerManager::registerPoolWorker( Socket* socket, const FeatureMessage& message )
+{
+	// only accept workers which have been started by us with a token unknown to other processes
+	const auto it = m_startingPoolWorkers.constFind( message.argument( PoolWorkerArgument::Token ).toString() );
+	if( it == m_startingPoolWorkers.constEnd() )
+	{
+		vWarning() << "ignoring unexpected pool worker";
+		socket->close();
+		return;
+	}
+
+#ifdef Q_OS_UNIX
+	// additionally make sure the worker runs as the user it has been started for
+	if( isPeerUser( socket, it->type == WorkerType::ManagedSystem ? QString{} : it->username ) == false )
+	{
+		vWarning() << "ignoring pool worker of unexpected user";
+		socket->close();
+		return;
+	}
+#endif
+
+	vDebug() << "pool worker ready" << it->username;
+
+	m_poolWorkers.append( { it->type, socket, it->process, it->username } );
+	m_startingPoolWorkers.erase( it );
+}
+
+
+
+bool FeatureWorkerManager::assignPoolWorker( WorkerType type, Feature::Uid featureUid )
+{
+	discardStalePoolWorkers( VeyonCore::platform().userFunctions().currentUser() );
+
+	for( auto it = m_poolWorkers.begin(); it != m_poolWorkers.end(); ++it )
+	{
+		if( it->type != type )
+		{
+			continue;
+		}
+
+		vDebug() << "assigning pool worker to feature" << VeyonCore::featureManager().feature(featureUid).name();
+
+		Worker worker;
+		worker.socket = it->socket;
+		worker.process = it->process;
+
+		m_poolWorkers.erase( it );
+
+		// make the worker initialize the feature before any further message is sent to it
+		FeatureMessage( featureUid, FeatureMessage::Command::Init ).sendPlain( worker.socket );
+
+		m_workersMutex.lock();
+		m_workers[featureUid] = worker;
+		m_workersMutex.unlock();
+
+		Q_EMIT workersChanged();
+
+		// refill pool in the background
+		QTimer::singleShot( 0, this, &FeatureWorkerManager::fillWorkerPool );
+
+		return true;
+	}
+
+	return false;
 }
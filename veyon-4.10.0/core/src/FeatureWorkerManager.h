@@ -24,13 +24,21 @@
 
 #pragma once
 
+#include <QElapsedTimer>
 #include <QPointer>
 #include <QProcess>
-#include <QTcpServer>
-#include <QTcpSocket>
+#include <QTimer>
 
 #include <QRecursiveMutex>
 
+#ifdef Q_OS_WIN
+#include <QTcpServer>
+#include <QTcpSocket>
+#else
+#include <QLocalServer>
+#include <QLocalSocket>
+#endif
+
 #include "FeatureMessage.h"
 
 class FeatureManager;
@@ -52,24 +60,77 @@ public:
 	void sendMessageToUnmanagedSessionWorker( const FeatureMessage& message );
 
 	bool isWorkerRunning( Feature::Uid featureUid );
+	FeatureUidList runningWorkers();
+
+#ifdef Q_OS_WIN
+	// named pipes could be created by any local user before the server listens and would allow
+	// impersonating connecting workers, so keep using a socket on the loopback interface there
+	using Server = QTcpServer;
+	using Socket = QTcpSocket;
+
+	static quint16 serverPort();
+#else
+	using Server = QLocalServer;
+	using Socket = QLocalSocket;
+
+	static QString serverName();
+#endif
+
+	// pooled workers are started with this argument instead of a feature UID, identify themselves
+	// with a token passed through stdin (or as next argument for session workers) and get
+	// assigned a feature through an init message later
+	static QString poolWorkerArgument()
+	{
+		return QStringLiteral("pool");
+	}
+
+	enum class PoolWorkerArgument
+	{
+		Token
+	};
+
+Q_SIGNALS:
+	void workersChanged();
 
 private:
 	void acceptConnection();
-	void processConnection( QTcpSocket* socket );
-	void closeConnection( QTcpSocket* socket );
+	void processConnection( Socket* socket );
+	void closeConnection( Socket* socket );
 
 	void sendMessage( const FeatureMessage& message );
 
-	void sendPendingMessages();
+	struct Worker;
+	void sendPendingMessages( Worker& worker );
+
+	enum class WorkerType
+	{
+		ManagedSystem,
+		UnmanagedSession
+	};
+
+	QProcess* startWorkerProcess( const QStringList& arguments );
+
+#ifdef Q_OS_UNIX
+	static QString socketDirectory();
+	static bool prepareSocketDirectory();
+	static bool isPeerUser( Socket* socket, const QString& username );
+#endif
+	void grantSessionUserAccess( const QString& username );
+
+	void fillWorkerPool();
+	void discardStalePoolWorkers( const QString& currentUser );
+	void registerPoolWorker( Socket* socket, const FeatureMessage& message );
+	bool assignPoolWorker( WorkerType type, Feature::Uid featureUid );
 
 	static constexpr auto UnmanagedSessionProcessRetryInterval = 5000;
+	static constexpr auto PoolWorkerStartTimeout = 30000;
 
 	VeyonServerInterface& m_server;
-	QTcpServer m_tcpServer;
+	Server m_workerServer;
 
 	struct Worker
 	{
-		QPointer<QTcpSocket> socket;
+		QPointer<Socket> socket;
 		QPointer<QProcess> process;
 		QList<FeatureMessage> pendingMessages;
 	};
@@ -77,6 +138,27 @@ private:
 	using WorkerMap = QMap<Feature::Uid, Worker>;
 	WorkerMap m_workers;
 
+	struct PoolWorker
+	{
+		WorkerType type;
+		QPointer<Socket> socket;
+		QPointer<QProcess> process;
+		QString username;
+	};
+
+	struct StartingPoolWorker
+	{
+		WorkerType type{WorkerType::ManagedSystem};
+		QPointer<QProcess> process;
+		QString username;
+		QElapsedTimer startTimer;
+	};
+
+	const int m_workerPoolSize;
+	QList<PoolWorker> m_poolWorkers;
+	QHash<QString, StartingPoolWorker> m_startingPoolWorkers;
+	QTimer m_workerPoolTimer{this};
+
 	QRecursiveMutex m_workersMutex;
 
 } ;
@@ -112,6 +112,16 @@ void MonitoringMode::setMinimumFramebufferUpdateInterval(const ComputerControlIn
 
 
 
+void MonitoringMode::setScaledFramebufferSize(const ComputerControlInterfaceList& computerControlInterfaces, QSize size)
+{
+	sendFeatureMessage(FeatureMessage{m_monitoringModeFeature.uid(), FeatureCommand::SetScaledFramebufferSize}
+					   .addArgument(Argument::ScaledFramebufferWidth, size.width())
+					   .addArgument(Argument::ScaledFramebufferHeight, size.height()),
+					   computerControlInterfaces);
+}
+
+
+
 void MonitoringMode::queryApplicationVersion(const ComputerControlInterfaceList& computerControlInterfaces)
 {
 	sendFeatureMessage(FeatureMessage{m_queryApplicationVersionFeature.uid()}, computerControlInterfaces);
@@ -168,6 +178,7 @@ bool MonitoringMode::handleFeatureMessage( ComputerControlInterface::Pointer com
 
 	if (message.featureUid() == m_queryApplicationVersionFeature.uid())
 	{
+		computerControlInterface->setCompactFeatureMessages(message.argument(Argument::CompactFeatureMessages).toBool());
 		computerControlInterface->setServerVersion(message.argument(Argument::ApplicationVersion)
 												   .value<VeyonCore::ApplicationVersion>());
 		return true;
@@ -263,13 +274,22 @@ bool MonitoringMode::handleFeatureMessage(VeyonServerInterface& server,
 													   message.argument(Argument::MinimumFramebufferUpdateInterval).toInt());
 			return true;
 		}
+
+		if (message.command<FeatureCommand>() == FeatureCommand::SetScaledFramebufferSize)
+		{
+			server.setScaledFramebufferSize(messageContext,
+											message.argument(Argument::ScaledFramebufferWidth).toInt(),
+											message.argument(Argument::ScaledFramebufferHeight).toInt());
+			return true;
+		}
 	}
 
 	if (message.featureUid() == m_queryApplicationVersionFeature.uid())
 	{
 		server.sendFeatureMessageReply(messageContext,
 									   FeatureMessage{m_queryApplicationVersionFeature.uid()}
-									   .addArgument(Argument::ApplicationVersion, int(VeyonCore::config().applicationVersion())));
+									   .addArgument(Argument::ApplicationVersion, int(VeyonCore::config().applicationVersion()))
+									   .addArgument(Argument::CompactFeatureMessages, true));
 	}
 
 	if (m_queryActiveFeatures.uid() == message.featureUid())
@@ -309,38 +329,48 @@ bool MonitoringMode::handleFeatureMessage(VeyonServerInterface& server,
 
 void MonitoringMode::sendAsyncFeatureMessages(VeyonServerInterface& server, const MessageContext& messageContext)
 {
-	const auto activeFeaturesVersion = messageContext.ioDevice()->property(activeFeaturesVersionProperty()).toInt();
+	// the connection only serves as key and is never dereferenced as it may live in another thread
+	const auto connection = messageContext.connection();
+	if (connection == nullptr)
+	{
+		return;
+	}
 
-	if (activeFeaturesVersion != m_activeFeaturesVersion)
+	auto& client = m_clients[connection];
+
+	// fast path for the common case of nothing having changed since the last call for this client
+	const auto stateVersion = m_stateVersion.loadAcquire();
+	if (client.stateVersion == stateVersion)
+	{
+		return;
+	}
+
+	client.stateVersion = stateVersion;
+
+	if (client.activeFeaturesVersion != m_activeFeaturesVersion)
 	{
 		sendActiveFeatures(server, messageContext);
-		messageContext.ioDevice()->setProperty(activeFeaturesVersionProperty(), m_activeFeaturesVersion);
+		client.activeFeaturesVersion = m_activeFeaturesVersion;
 	}
 
 	const auto currentUserInfoVersion = m_userInfoVersion.loadAcquire();
-	const auto contextUserInfoVersion = messageContext.ioDevice()->property(userInfoVersionProperty()).toInt();
-
-	if(contextUserInfoVersion != currentUserInfoVersion)
+	if (client.userInfoVersion != currentUserInfoVersion)
 	{
 		sendUserInformation(server, messageContext);
-		messageContext.ioDevice()->setProperty(userInfoVersionProperty(), currentUserInfoVersion);
+		client.userInfoVersion = currentUserInfoVersion;
 	}
 
 	const auto currentSessionInfoVersion = m_sessionInfoVersion.loadAcquire();
-	const auto sessionInfoVersion = messageContext.ioDevice()->property(sessionInfoVersionProperty()).toInt();
-
-	if (sessionInfoVersion != currentSessionInfoVersion)
+	if (client.sessionInfoVersion != currentSessionInfoVersion)
 	{
 		sendSessionInfo(server, messageContext);
-		messageContext.ioDevice()->setProperty(sessionInfoVersionProperty(), currentSessionInfoVersion);
+		client.sessionInfoVersion = currentSessionInfoVersion;
 	}
 
-	const auto screenInfoVersion = messageContext.ioDevice()->property(screenInfoListVersionProperty()).toInt();
-
-	if (screenInfoVersion != m_screenInfoListVersion)
+	if (client.screenInfoListVersion != m_screenInfoListVersion)
 	{
 		sendScreenInfoList(server, messageContext);
-		messageContext.ioDevice()->setProperty(screenInfoListVersionProperty(), m_screenInfoListVersion);
+		client.screenInfoListVersion = m_screenInfoListVersion;
 	}
 }
 
@@ -440,6 +470,52 @@ bool MonitoringMode::sendScreenInfoList(VeyonServerInterface& server, const Mess
 
 
 
+void MonitoringMode::scheduleActiveFeaturesUpdate()
+{
+	// coalesce multiple requests (e.g. from a burst of feature messages) into a single update
+	if (m_activeFeaturesUpdatePending == false)
+	{
+		m_activeFeaturesUpdatePending = true;
+		QMetaObject::invokeMethod(this, [this]() {
+			m_activeFeaturesUpdatePending = false;
+			updateActiveFeatures();
+		}, Qt::QueuedConnection);
+	}
+}
+
+
+
+void MonitoringMode::notifyStateChanged()
+{
+	m_stateVersion.ref();
+
+	// may be called from arbitrary threads so defer pushing to the thread of this object
+	if (m_stateChangePushPending.testAndSetOrdered(0, 1))
+	{
+		QMetaObject::invokeMethod(this, &MonitoringMode::pushStateChanges, Qt::QueuedConnection);
+	}
+}
+
+
+
+void MonitoringMode::pushStateChanges()
+{
+	m_stateChangePushPending.storeRelease(0);
+
+	// the server knows which connections are alive and in which thread they are served,
+	// so let it call sendAsyncFeatureMessages() for each of them
+	Q_EMIT stateChanged();
+}
+
+
+
+void MonitoringMode::removeClient(const QObject* connection)
+{
+	m_clients.remove(connection);
+}
+
+
+
 void MonitoringMode::updateActiveFeatures()
 {
 	const auto server = VeyonCore::instance()->findChild<VeyonServerInterface *>();
@@ -459,6 +535,7 @@ void MonitoringMode::updateActiveFeatures()
 		{
 			m_activeFeatures = activeFeatures;
 			m_activeFeaturesVersion++;
+			notifyStateChanged();
 		}
 	}
 }
@@ -481,6 +558,7 @@ void MonitoringMode::updateUserInfo()
 				m_userLoginName = userLoginName;
 				m_userFullName = userFullName;
 				++m_userInfoVersion;
+				notifyStateChanged();
 			}
 			m_userDataLock.unlock();
 		}
@@ -526,6 +604,7 @@ void MonitoringMode::updateSessionInfo()
 		{
 			m_sessionInfo = currentSessionInfo;
 			++m_sessionInfoVersion;
+			notifyStateChanged();
 		}
 		m_sessionInfoLock.unlock();
 	});
@@ -557,6 +636,7 @@ void MonitoringMode::updateScreenInfoList()
 	{
 		m_screenInfoList = screenInfoList;
 		++m_screenInfoListVersion;
+		notifyStateChanged();
 	}
 }
 
@@ -49,10 +49,17 @@ public:
 		SessionMetaData,
 		UserIdentity,
 		UserIdentificationContextId,
+		ScaledFramebufferWidth,
+		ScaledFramebufferHeight,
+		CompactFeatureMessages,
 		ActiveFeaturesList = 0 // for compatibility after migration from FeatureControl
 	};
 	Q_ENUM(Argument)
 
+	// minimum framebuffer update interval which makes the server discard throttled update
+	// requests instead of deferring them, i.e. framebuffer updates are suspended
+	static constexpr int SuspendedFramebufferUpdateInterval = 5000;
+
 	explicit MonitoringMode( QObject* parent = nullptr );
 
 	const Feature& feature() const
@@ -67,7 +74,7 @@ public:
 
 	QVersionNumber version() const override
 	{
-		return QVersionNumber( 1, 2 );
+		return QVersionNumber( 1, 3 );
 	}
 
 	QString name() const override
@@ -100,6 +107,8 @@ public:
 	void setMinimumFramebufferUpdateInterval(const ComputerControlInterfaceList& computerControlInterfaces,
 											 int interval);
 
+	void setScaledFramebufferSize(const ComputerControlInterfaceList& computerControlInterfaces, QSize size);
+
 	void queryApplicationVersion(const ComputerControlInterfaceList& computerControlInterfaces);
 
 	void queryActiveFeatures(const ComputerControlInterfaceList& computerControlInterfaces);
@@ -136,32 +145,33 @@ public:
 
 	bool handleFeatureMessage(VeyonWorkerInterface& worker, const FeatureMessage& message) override;
 
+	void scheduleActiveFeaturesUpdate();
+
+	// has to be called from the main thread once a connection has been closed
+	void removeClient(const QObject* connection);
+
+Q_SIGNALS:
+	void stateChanged();
+
 private:
+	struct ClientState
+	{
+		int stateVersion{-1};
+		int activeFeaturesVersion{0};
+		int userInfoVersion{0};
+		int sessionInfoVersion{0};
+		int screenInfoListVersion{0};
+	};
+
+
 	bool sendActiveFeatures(VeyonServerInterface& server, const MessageContext& messageContext);
 	bool sendUserInformation(VeyonServerInterface& server, const MessageContext& messageContext);
 	bool sendSessionInfo(VeyonServerInterface& server, const MessageContext& messageContext);
 	bool sendScreenInfoList(VeyonServerInterface& server, const MessageContext& messageContext);
 	void queryUsername();
 
-	static const char* activeFeaturesVersionProperty()
-	{
-		return "activeFeaturesListVersion";
-	}
-
-	static const char* userInfoVersionProperty()
-	{
-		return "userInfoVersion";
-	}
-
-	static const char* sessionInfoVersionProperty()
-	{
-		return "sessionInfoVersion";
-	}
-
-	static const char* screenInfoListVersionProperty()
-	{
-		return "screenInfoListVersion";
-	}
+	void notifyStateChanged();
+	void pushStateChanges();
 
 	void updateActiveFeatures();
 	void updateUserInfo();
@@ -173,10 +183,13 @@ private:
 	enum class FeatureCommand
 	{
 		Ping,
-		SetMinimumFramebufferUpdateInterval
+		SetMinimumFramebufferUpdateInterval,
+		SetScaledFramebufferSize
 	};
 
-	static constexpr int ActiveFeaturesUpdateInterval = 250;
+	// active features are updated on feature messages and worker changes, polling only
+	// catches features changing their state on their own
+	static constexpr int ActiveFeaturesUpdateInterval = 1000;
 	static constexpr int SessionInfoUpdateInterval = 1000;
 	static constexpr int UserInfoUpdateRetryInterval = 1000;
 
@@ -193,9 +206,14 @@ private:
 		m_identifyUserFeature
 	};
 
+	QHash<const QObject *, ClientState> m_clients;
+	QAtomicInt m_stateVersion{0};
+	QAtomicInt m_stateChangePushPending{0};
+
 	int m_activeFeaturesVersion{0};
 	QStringList m_activeFeatures;
 	QTimer m_activeFeaturesUpdateTimer;
+	bool m_activeFeaturesUpdatePending{false};
 
 	QReadWriteLock m_userDataLock;
 	QString m_userLoginName;
@@ -46,8 +46,14 @@ public:
 
 		// client has to prove its authenticity by knowing common token
 		Token,
+
+		// client presents a ticket issued by the server after a previous successful authentication
+		SessionTicket,
 	} ;
 
 	Q_ENUM(Type)
 
+	// upper bound for session ticket lifetimes in seconds as configured on the server and accepted by clients
+	static constexpr int MaximumSessionTicketLifetime = 24 * 60 * 60;
+
 };
@@ -40,13 +40,20 @@ VariantArrayMessage::VariantArrayMessage( QIODevice* ioDevice ) :
 
 
 
-bool VariantArrayMessage::send()
+bool VariantArrayMessage::send(const QByteArray& header)
 {
-	const auto messageSize = qToBigEndian<MessageSize>( static_cast<MessageSize>( m_buffer.size() ) );
-	m_ioDevice->write( reinterpret_cast<const char *>( &messageSize ), sizeof(messageSize) );
-	m_ioDevice->write( m_buffer.data() );
-
-	return true;
+	const auto& payload = m_buffer.data();
+	const auto messageSize = qToBigEndian<MessageSize>( static_cast<MessageSize>( payload.size() ) );
+
+	// assemble everything in one buffer so unbuffered devices (e.g. SocketDevice) do not issue
+	// a separate system call and TCP segment for each part
+	QByteArray data;
+	data.reserve( header.size() + int(sizeof(messageSize)) + payload.size() );
+	data.append( header );
+	data.append( reinterpret_cast<const char *>( &messageSize ), sizeof(messageSize) );
+	data.append( payload );
+
+	return m_ioDevice->write( data ) == data.size();
 }
 
 
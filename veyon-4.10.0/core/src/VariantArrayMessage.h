@@ -38,7 +38,9 @@ public:
 
 	explicit VariantArrayMessage( QIODevice* ioDevice );
 
-	bool send();
+	/** \brief Writes the message in a single write operation, optionally preceded by header data
+	 *  such as an RFB message type */
+	bool send(const QByteArray& header = {});
 
 	bool isReadyForReceive();
 
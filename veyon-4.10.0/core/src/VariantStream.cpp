@@ -23,6 +23,7 @@
  */
 
 #include <QIODevice>
+#include <QRect>
 #include <QUuid>
 #include <QVariant>
 
@@ -41,15 +42,14 @@ QVariant VariantStream::read() // Flawfinder: ignore
 	QVariant v;
 
 	m_dataStream.startTransaction();
-	const auto isValid = checkVariant(0);
-	m_dataStream.rollbackTransaction();
 
-	if (isValid == false)
+	if (readVariant(v, 0) == false)
 	{
+		m_dataStream.rollbackTransaction();
 		return {};
 	}
 
-	m_dataStream >> v;
+	m_dataStream.commitTransaction();
 
 	if( v.isValid() == false || v.isNull() )
 	{
@@ -68,16 +68,17 @@ void VariantStream::write( const QVariant& v )
 
 
 
-bool VariantStream::checkBool()
+bool VariantStream::readBool(QVariant& value)
 {
 	bool b;
 	m_dataStream >> b;
+	value = b;
 	return m_dataStream.status() == QDataStream::Status::Ok;
 }
 
 
 
-bool VariantStream::checkByteArray()
+bool VariantStream::readByteArray(QVariant& value)
 {
 	const auto pos = m_dataStream.device()->pos();
 
@@ -87,7 +88,8 @@ bool VariantStream::checkByteArray()
 	// null array?
 	if (len == 0xffffffff)
 	{
-		return true;
+		value = QByteArray();
+		return m_dataStream.status() == QDataStream::Status::Ok;
 	}
 
 	if (len > MaxByteArraySize)
@@ -98,42 +100,50 @@ bool VariantStream::checkByteArray()
 
 	m_dataStream.device()->seek(pos);
 
-	QByteArray s;
-	m_dataStream >> s;
+	QByteArray byteArray;
+	m_dataStream >> byteArray;
+	value = byteArray;
 
 	return m_dataStream.status() == QDataStream::Status::Ok;
 }
 
 
 
-bool VariantStream::checkInt()
+bool VariantStream::readInt(QVariant& value)
 {
-	int i;
+	qint32 i;
 	m_dataStream >> i;
+	value = i;
 	return m_dataStream.status() == QDataStream::Status::Ok;
 }
 
 
 
-bool VariantStream::checkLong()
+bool VariantStream::readLong(QVariant& value)
 {
 	qlonglong i;
 	m_dataStream >> i;
+	value = i;
 	return m_dataStream.status() == QDataStream::Status::Ok;
 }
 
 
 
-bool VariantStream::checkRect()
+bool VariantStream::readRect(QVariant& value)
 {
-	qint32 i;
-	m_dataStream >> i >> i >> i >> i;
+	qint32 x1, y1, x2, y2;
+	m_dataStream >> x1 >> y1 >> x2 >> y2;
+
+	QRect rect;
+	rect.setCoords(x1, y1, x2, y2);
+	value = rect;
+
 	return m_dataStream.status() == QDataStream::Status::Ok;
 }
 
 
 
-bool VariantStream::checkString()
+bool VariantStream::readString(QString& string)
 {
 	const auto pos = m_dataStream.device()->pos();
 
@@ -143,7 +153,8 @@ bool VariantStream::checkString()
 	// null string?
 	if (len == 0xffffffff)
 	{
-		return true;
+		string = QString();
+		return m_dataStream.status() == QDataStream::Status::Ok;
 	}
 
 	if (len > MaxStringSize)
@@ -154,48 +165,60 @@ bool VariantStream::checkString()
 
 	m_dataStream.device()->seek(pos);
 
-	QString s;
-	m_dataStream >> s;
+	m_dataStream >> string;
 
 	return m_dataStream.status() == QDataStream::Status::Ok;
 }
 
 
 
-bool VariantStream::checkStringList()
+bool VariantStream::readStringList(QVariant& value)
 {
 	quint32 n;
 	m_dataStream >> n;
 
+	if (m_dataStream.status() != QDataStream::Status::Ok)
+	{
+		return false;
+	}
+
 	if (n > MaxContainerSize)
 	{
 		vDebug() << "QStringList has too many elements";
 		return false;
 	}
 
+	QStringList stringList;
+	stringList.reserve(int(n));
+
 	for (quint32 i = 0; i < n; ++i)
 	{
-		if (checkString() == false)
+		QString string;
+		if (readString(string) == false)
 		{
 			return false;
 		}
+		stringList.append(string);
 	}
 
-	return m_dataStream.status() == QDataStream::Status::Ok;
+	value = stringList;
+
+	return true;
 }
 
 
 
-bool VariantStream::checkUuid()
+bool VariantStream::readUuid(QVariant& value)
 {
 	QUuid uuid;
 	m_dataStream >> uuid;
+	value = uuid;
 	return m_dataStream.status() == QDataStream::Status::Ok;
 }
 
 
 
-bool VariantStream::checkVariant(int depth)
+bool VariantStream::readVariant(QVariant& value, int depth)
 {
 	if (depth > MaxCheckRecursionDepth)
 	{
@@ -209,71 +232,107 @@ bool VariantStream::checkVariant(int depth)
 	quint8 isNull = false;
 	m_dataStream >> isNull;
 
+	if (m_dataStream.status() != QDataStream::Status::Ok)
+	{
+		return false;
+	}
+
 	switch(typeId)
 	{
-	case QMetaType::Bool: return checkBool();
-	case QMetaType::QByteArray: return checkByteArray();
-	case QMetaType::Int: return checkInt();
-	case QMetaType::LongLong: return checkLong();
-	case QMetaType::QRect: return checkRect();
-	case QMetaType::QString: return checkString();
-	case QMetaType::QStringList: return checkStringList();
-	case QMetaType::QUuid: return checkUuid();
-	case QMetaType::QVariantList: return checkVariantList(depth);
-	case QMetaType::QVariantMap: return checkVariantMap(depth);
+	case QMetaType::Bool: return readBool(value);
+	case QMetaType::QByteArray: return readByteArray(value);
+	case QMetaType::Int: return readInt(value);
+	case QMetaType::LongLong: return readLong(value);
+	case QMetaType::QRect: return readRect(value);
+	case QMetaType::QString:
+	{
+		QString string;
+		if (readString(string) == false)
+		{
+			return false;
+		}
+		value = string;
+		return true;
+	}
+	case QMetaType::QStringList: return readStringList(value);
+	case QMetaType::QUuid: return readUuid(value);
+	case QMetaType::QVariantList: return readVariantList(value, depth);
+	case QMetaType::QVariantMap: return readVariantMap(value, depth);
 	default:
 		vDebug() << "invalid type" << typeId;
 		return false;
 	}
-
-	return m_dataStream.status() == QDataStream::Status::Ok;
 }
 
 
 
-bool VariantStream::checkVariantList(int depth)
+bool VariantStream::readVariantList(QVariant& value, int depth)
 {
 	quint32 n;
 	m_dataStream >> n;
 
+	if (m_dataStream.status() != QDataStream::Status::Ok)
+	{
+		return false;
+	}
+
 	if (n > MaxContainerSize)
 	{
 		vDebug() << "QVariantList has too many elements";
 		return false;
 	}
 
+	QVariantList variantList;
+	variantList.reserve(int(n));
+
 	for (quint32 i = 0; i < n; ++i)
 	{
-		if (checkVariant(depth+1) == false)
+		QVariant element;
+		if (readVariant(element, depth+1) == false)
 		{
 			return false;
 		}
+		variantList.append(element);
 	}
 
-	return m_dataStream.status() == QDataStream::Status::Ok;
+	value = variantList;
+
+	return true;
 }
 
 
 
-bool VariantStream::checkVariantMap(int depth)
+bool VariantStream::readVariantMap(QVariant& value, int depth)
 {
 	quint32 n;
 	m_dataStream >> n;
 
+	if (m_dataStream.status() != QDataStream::Status::Ok)
+	{
+		return false;
+	}
+
 	if (n > MaxContainerSize)
 	{
 		vDebug() << "QVariantMap has too many elements";
 		return false;
 	}
 
+	QVariantMap variantMap;
+
 	for (quint32 i = 0; i < n; ++i)
 	{
-		if (checkString() == false ||
-			checkVariant(depth+1) == false)
+		QString key;
+		QVariant element;
+		if (readString(key) == false ||
+			readVariant(element, depth+1) == false)
 		{
 			return false;
 		}
+		variantMap[key] = element;
 	}
 
-	return m_dataStream.status() == QDataStream::Status::Ok;
+	value = variantMap;
+
+	return true;
 }
@@ -43,17 +43,18 @@ public:
 	void write( const QVariant& v );
 
 private:
-	bool checkBool();
-	bool checkByteArray();
-	bool checkInt();
-	bool checkLong();
-	bool checkRect();
-	bool checkString();
-	bool checkStringList();
-	bool checkUuid();
-	bool checkVariant(int depth);
-	bool checkVariantList(int depth);
-	bool checkVariantMap(int depth);
+	// each function validates the data while reading it so that untrusted input is parsed only once
+	bool readBool(QVariant& value);
+	bool readByteArray(QVariant& value);
+	bool readInt(QVariant& value);
+	bool readLong(QVariant& value);
+	bool readRect(QVariant& value);
+	bool readString(QString& string);
+	bool readStringList(QVariant& value);
+	bool readUuid(QVariant& value);
+	bool readVariant(QVariant& value, int depth);
+	bool readVariantList(QVariant& value, int depth);
+	bool readVariantMap(QVariant& value, int depth);
 
 	QDataStream m_dataStream;
 
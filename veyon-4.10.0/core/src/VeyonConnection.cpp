@@ -22,6 +22,9 @@
  *
  */
 
+#include <QDateTime>
+#include <QMessageAuthenticationCode>
+
 #include "rfb/rfbclient.h"
 
 #include "AuthenticationProxy.h"
@@ -99,11 +102,18 @@ void VeyonConnection::stopAndDeleteLater()
 
 
 
-void VeyonConnection::sendFeatureMessage(const FeatureMessage& featureMessage)
+void VeyonConnection::sendFeatureMessage(const FeatureMessage& featureMessage, const QByteArray& rfbMessage)
 {
 	if( m_vncConnection )
 	{
-		m_vncConnection->enqueueEvent(new VncFeatureMessageEvent(featureMessage));
+		if( rfbMessage.isEmpty() && m_compactFeatureMessages )
+		{
+			m_vncConnection->enqueueEvent(new VncFeatureMessageEvent(featureMessage, featureMessage.toCompactRfbMessage()));
+		}
+		else
+		{
+			m_vncConnection->enqueueEvent(new VncFeatureMessageEvent(featureMessage, rfbMessage));
+		}
 	}
 }
 
@@ -111,11 +121,12 @@ void VeyonConnection::sendFeatureMessage(const FeatureMessage& featureMessage)
 
 bool VeyonConnection::handleServerMessage( rfbClient* client, uint8_t msg )
 {
-	if( msg == FeatureMessage::RfbMessageType )
+	if( msg == FeatureMessage::RfbMessageType || msg == FeatureMessage::CompactRfbMessageType )
 	{
 		SocketDevice socketDev( VncConnection::libvncClientDispatcher, client );
 		FeatureMessage featureMessage;
-		if( featureMessage.receive( &socketDev ) == false )
+		if( ( msg == FeatureMessage::CompactRfbMessageType ? featureMessage.receiveCompact( &socketDev )
+														   : featureMessage.receive( &socketDev ) ) == false )
 		{
 			vDebug() << "could not receive feature message";
 
@@ -238,6 +249,20 @@ rfbBool VeyonConnection::handleSecTypeVeyon( rfbClient* client, uint32_t authSch
 		chosenAuthType = connection->veyonAuthType();
 	}
 
+	// username which is used when displaying an access confirm dialog
+	const auto username = connection->authenticationCredentials().hasCredentials( AuthenticationCredentials::Type::UserLogon ) ?
+							  connection->authenticationCredentials().logonUsername() :
+							  VeyonCore::platform().userFunctions().currentUser();
+
+	// skip expensive authentication if the server issued a ticket during a previous connection
+	const auto serverAddress = QStringLiteral("%1:%2").arg( QString::fromUtf8( client->serverHost ) ).arg( client->serverPort );
+	const auto useSessionTickets = proxy == nullptr && authTypes.contains( RfbVeyonAuth::SessionTicket );
+	const auto sessionTicket = useSessionTickets ? takeSessionTicket( serverAddress, username ) : SessionTicket{};
+	if( sessionTicket.data.isEmpty() == false )
+	{
+		chosenAuthType = RfbVeyonAuth::SessionTicket;
+	}
+
 	if( chosenAuthType == RfbVeyonAuth::Invalid )
 	{
 		return FALSE;
@@ -245,19 +270,16 @@ rfbBool VeyonConnection::handleSecTypeVeyon( rfbClient* client, uint32_t authSch
 
 	vDebug() << QThread::currentThreadId() << "chose authentication type:" << authTypes;
 
+	const auto requestSessionTicket = useSessionTickets &&
+									  ( chosenAuthType == RfbVeyonAuth::KeyFile ||
+										chosenAuthType == RfbVeyonAuth::Logon ||
+										chosenAuthType == RfbVeyonAuth::SessionTicket );
+
 	VariantArrayMessage authReplyMessage( &socketDevice );
 
 	authReplyMessage.write( chosenAuthType );
-
-	// send username which is used when displaying an access confirm dialog
-	if( connection->authenticationCredentials().hasCredentials( AuthenticationCredentials::Type::UserLogon ) )
-	{
-		authReplyMessage.write( connection->authenticationCredentials().logonUsername() );
-	}
-	else
-	{
-		authReplyMessage.write( VeyonCore::platform().userFunctions().currentUser() );
-	}
+	authReplyMessage.write( username );
+	authReplyMessage.write( requestSessionTicket );
 
 	authReplyMessage.send();
 
@@ -268,6 +290,9 @@ rfbBool VeyonConnection::handleSecTypeVeyon( rfbClient* client, uint32_t authSch
 		return FALSE;
 	}
 
+	// random key for protecting the secret of a session ticket received after logon authentication
+	QByteArray sessionTicketMaskingKey;
+
 	switch( chosenAuthType )
 	{
 	case RfbVeyonAuth::KeyFile:
@@ -323,6 +348,15 @@ rfbBool VeyonConnection::handleSecTypeVeyon( rfbClient* client, uint32_t authSch
 
 		VariantArrayMessage passwordResponse( &socketDevice );
 		passwordResponse.write( encryptedPassword.toByteArray() );
+
+		if( requestSessionTicket )
+		{
+			// never derive the key from the password as the masked secret can be observed on the network
+			sessionTicketMaskingKey = CryptoCore::generateChallenge().left( SessionTicketSecretSize );
+			passwordResponse.write( publicKey.encrypt( CryptoCore::SecureArray( sessionTicketMaskingKey ),
+													   CryptoCore::DefaultEncryptionAlgorithm ).toByteArray() );
+		}
+
 		passwordResponse.send();
 		break;
 	}
@@ -335,16 +369,128 @@ rfbBool VeyonConnection::handleSecTypeVeyon( rfbClient* client, uint32_t authSch
 		break;
 	}
 
+	case RfbVeyonAuth::SessionTicket:
+	{
+		VariantArrayMessage challengeReceiveMessage( &socketDevice );
+		challengeReceiveMessage.receive();
+		const auto challenge = challengeReceiveMessage.read().toByteArray(); // Flawfinder: ignore
+
+		if( challenge.size() != CryptoCore::ChallengeSize )
+		{
+			vCritical() << QThread::currentThreadId() << "challenge size mismatch!";
+			return FALSE;
+		}
+
+		// prove possession of the ticket secret without ever sending it
+		VariantArrayMessage sessionTicketMessage( &socketDevice );
+		sessionTicketMessage.write( sessionTicket.data );
+		sessionTicketMessage.write( QMessageAuthenticationCode::hash( challenge, sessionTicket.secret,
+																	  QCryptographicHash::Sha256 ) );
+		sessionTicketMessage.send();
+		break;
+	}
+
 	default:
 		// nothing to do - we just get accepted
 		break;
 	}
 
+	if( requestSessionTicket )
+	{
+		// server sends a new ticket upon successful authentication only
+		VariantArrayMessage sessionTicketMessage( &socketDevice );
+		if( sessionTicketMessage.receive() == false )
+		{
+			vDebug() << QThread::currentThreadId() << "authentication failed";
+			return FALSE;
+		}
+
+		const auto ticket = sessionTicketMessage.read().toByteArray(); // Flawfinder: ignore
+		const auto lifetime = sessionTicketMessage.read().toInt(); // Flawfinder: ignore
+		const auto encryptedSecret = sessionTicketMessage.read().toByteArray(); // Flawfinder: ignore
+
+		// the ticket secret is encrypted for our private key or masked with a key which has been
+		// transferred encrypted during logon authentication or with the previous ticket secret
+		QByteArray secret;
+		switch( chosenAuthType )
+		{
+		case RfbVeyonAuth::KeyFile:
+		{
+			auto key = connection->authenticationCredentials().privateKey();
+			CryptoCore::SecureArray decryptedSecret;
+			if( key.canDecrypt() &&
+				key.decrypt( CryptoCore::SecureArray( encryptedSecret ), &decryptedSecret,
+							 CryptoCore::DefaultEncryptionAlgorithm ) )
+			{
+				secret = decryptedSecret.toByteArray();
+			}
+			break;
+		}
+
+		case RfbVeyonAuth::Logon:
+			secret = CryptoCore::maskData( encryptedSecret, ticket, sessionTicketMaskingKey );
+			break;
+
+		case RfbVeyonAuth::SessionTicket:
+			secret = CryptoCore::maskData( encryptedSecret, ticket, sessionTicket.secret );
+			break;
+
+		default:
+			break;
+		}
+
+		storeSessionTicket( serverAddress, username, ticket, secret, lifetime );
+	}
+
 	return TRUE;
 }
 
 
 
+VeyonConnection::SessionTicket VeyonConnection::takeSessionTicket( const QString& serverAddress, const QString& username )
+{
+	QMutexLocker locker( &sessionTickets().mutex );
+
+	// tickets are valid for a single authentication only
+	const auto ticket = sessionTickets().tickets.take( serverAddress );
+	if( ticket.username == username &&
+		ticket.expirationTime > QDateTime::currentMSecsSinceEpoch() )
+	{
+		return ticket;
+	}
+
+	return {};
+}
+
+
+
+void VeyonConnection::storeSessionTicket( const QString& serverAddress, const QString& username,
+										  const QByteArray& ticket, const QByteArray& secret, int lifetime )
+{
+	if( ticket.isEmpty() || secret.size() != SessionTicketSecretSize ||
+		lifetime <= 0 || lifetime > RfbVeyonAuth::MaximumSessionTicketLifetime )
+	{
+		return;
+	}
+
+	QMutexLocker locker( &sessionTickets().mutex );
+
+	// leave some margin for clock differences and network latencies
+	sessionTickets().tickets[serverAddress] = {
+		username, ticket, secret, QDateTime::currentMSecsSinceEpoch() + qint64( lifetime ) * 1000 * 9 / 10
+	};
+}
+
+
+
+VeyonConnection::SessionTickets& VeyonConnection::sessionTickets()
+{
+	static SessionTickets sessionTickets;
+	return sessionTickets;
+}
+
+
+
 void VeyonConnection::hookPrepareAuthentication( rfbClient* client )
 {
 	auto connection = static_cast<VncConnection *>( VncConnection::clientData( client, VncConnection::VncConnectionTag ) );
@@ -41,6 +41,19 @@ public:
 		QHash<QThread *, VeyonConnection *> connections;
 	};
 
+	struct SessionTicket
+	{
+		QString username;
+		QByteArray data;
+		QByteArray secret;
+		qint64 expirationTime{0};
+	};
+
+	using SessionTickets = struct {
+		QMutex mutex;
+		QHash<QString, SessionTicket> tickets;
+	};
+
 	VeyonConnection();
 
 	void stopAndDeleteLater();
@@ -75,7 +88,18 @@ public:
 		m_authenticationProxy = authenticationProxy;
 	}
 
-	void sendFeatureMessage(const FeatureMessage& featureMessage);
+	// only enable after the server announced support for compact feature messages
+	void setCompactFeatureMessages( bool enabled )
+	{
+		m_compactFeatureMessages = enabled;
+	}
+
+	bool compactFeatureMessages() const
+	{
+		return m_compactFeatureMessages;
+	}
+
+	void sendFeatureMessage(const FeatureMessage& featureMessage, const QByteArray& rfbMessage = {});
 
 	bool handleServerMessage( rfbClient* client, uint8_t msg );
 
@@ -86,6 +110,8 @@ Q_SIGNALS:
 	void featureMessageReceived( const FeatureMessage& );
 
 private:
+	static constexpr int SessionTicketSecretSize = 32;
+
 	~VeyonConnection() override;
 
 	void registerConnection();
@@ -95,6 +121,11 @@ private:
 	static int8_t handleSecTypeVeyon( rfbClient* client, uint32_t authScheme );
 	static void hookPrepareAuthentication( rfbClient* client );
 
+	static SessionTicket takeSessionTicket( const QString& serverAddress, const QString& username );
+	static void storeSessionTicket( const QString& serverAddress, const QString& username,
+									const QByteArray& ticket, const QByteArray& secret, int lifetime );
+	static SessionTickets& sessionTickets();
+
 	AuthenticationCredentials authenticationCredentials() const;
 
 	VncConnection* m_vncConnection{new VncConnection};
@@ -104,4 +135,6 @@ private:
 	AuthenticationProxy* m_authenticationProxy{nullptr};
 	QString m_accessControlMessage;
 
+	bool m_compactFeatureMessages{false};
+
 } ;
@@ -50,4 +50,6 @@ public:
 
 	virtual void setMinimumFramebufferUpdateInterval(const MessageContext& context, int interval) = 0;
 
+	virtual void setScaledFramebufferSize(const MessageContext& context, int width, int height) = 0;
+
 };
@@ -28,7 +28,6 @@ extern "C"
 #include "d3des.h"
 }
 
-#include <QBuffer>
 #include <QRegion>
 #include <QRegularExpression>
 #include <QTcpSocket>
@@ -82,6 +81,7 @@ VncClientProtocol::VncClientProtocol( QIODevice* socket, const Password& vncPass
 void VncClientProtocol::start()
 {
 	m_state = Protocol;
+	m_framebufferUpdate = {};
 }
 
 
@@ -195,6 +195,19 @@ void VncClientProtocol::requestFramebufferUpdate( bool incremental )
 
 
 
+bool VncClientProtocol::sendFramebufferScale( uint8_t scale )
+{
+	rfbSetScaleMsg setScaleMessage;
+
+	setScaleMessage.type = rfbSetScale;
+	setScaleMessage.scale = scale;
+	setScaleMessage.pad = 0;
+
+	return m_socket->write( reinterpret_cast<const char *>( &setScaleMessage ), sz_rfbSetScaleMsg ) == sz_rfbSetScaleMsg;
+}
+
+
+
 bool VncClientProtocol::receiveMessage()
 {
 	if( m_socket->bytesAvailable() > MaximumMessageSize )
@@ -204,6 +217,12 @@ bool VncClientProtocol::receiveMessage()
 		return false;
 	}
 
+	// continue receiving a partially received framebuffer update
+	if( m_framebufferUpdate.message.isEmpty() == false )
+	{
+		return receiveFramebufferUpdateMessage();
+	}
+
 	uint8_t messageType = 0;
 	if( m_socket->peek( reinterpret_cast<char *>( &messageType ), sizeof(messageType) ) != sizeof(messageType) )
 	{
@@ -433,58 +452,100 @@ bool VncClientProtocol::receiveServerInitMessage()
 
 bool VncClientProtocol::receiveFramebufferUpdateMessage()
 {
-	// peek all available data and work on a local buffer so we can continously read from it
-	auto data = m_socket->peek( m_socket->bytesAvailable() );
-
-	QBuffer buffer( &data );
-	buffer.open( QBuffer::ReadOnly ); // Flawfinder: ignore
+	// bytes are moved from the socket into our message buffer only as far as required
+	// for parsing and parsing continues where it stopped last time, so large updates
+	// arriving in many small segments are not parsed over and over again
+	auto& update = m_framebufferUpdate;
 
-	rfbFramebufferUpdateMsg message;
-	if( buffer.read( reinterpret_cast<char *>( &message ), sz_rfbFramebufferUpdateMsg ) != sz_rfbFramebufferUpdateMsg )
+	if( update.rectCount < 0 )
 	{
-		return false;
-	}
-
-	QRegion updatedRegion;
+		// updates tend to have similar sizes, so avoid repeatedly growing (and thereby
+		// copying) the buffer while segments of a large update arrive
+		if( update.message.capacity() < m_framebufferUpdateSizeHint )
+		{
+			update.message.reserve( m_framebufferUpdateSizeHint );
+		}
 
-	const auto nRects = qFromBigEndian( message.nRects );
+		FramebufferUpdateReader reader( *this, 0 );
 
-	for( int i = 0; i < nRects; ++i )
-	{
-		rfbFramebufferUpdateRectHeader rectHeader;
-		if( buffer.read( reinterpret_cast<char *>( &rectHeader ), sz_rfbFramebufferUpdateRectHeader ) != sz_rfbFramebufferUpdateRectHeader )
+		rfbFramebufferUpdateMsg message;
+		if( reader.read( &message, sz_rfbFramebufferUpdateMsg ) == false ) // Flawfinder: ignore
 		{
 			return false;
 		}
 
-		rectHeader.encoding = qFromBigEndian( rectHeader.encoding );
-		rectHeader.r.w = qFromBigEndian( rectHeader.r.w );
-		rectHeader.r.h = qFromBigEndian( rectHeader.r.h );
-		rectHeader.r.x = qFromBigEndian( rectHeader.r.x );
-		rectHeader.r.y = qFromBigEndian( rectHeader.r.y );
+		update.rectCount = qFromBigEndian( message.nRects );
+		update.pos = reader.pos();
+	}
+
+	while( update.rectIndex < update.rectCount )
+	{
+		auto& rectHeader = update.rectHeader;
 
-		if( rectHeader.encoding == rfbEncodingLastRect )
+		if( update.rectHeaderValid == false )
 		{
-			break;
+			FramebufferUpdateReader reader( *this, update.pos );
+			if( reader.read( &rectHeader, sz_rfbFramebufferUpdateRectHeader ) == false ) // Flawfinder: ignore
+			{
+				return false;
+			}
+
+			rectHeader.encoding = qFromBigEndian( rectHeader.encoding );
+			rectHeader.r.w = qFromBigEndian( rectHeader.r.w );
+			rectHeader.r.h = qFromBigEndian( rectHeader.r.h );
+			rectHeader.r.x = qFromBigEndian( rectHeader.r.x );
+			rectHeader.r.y = qFromBigEndian( rectHeader.r.y );
+
+			update.pos = reader.pos();
+			update.rectHeaderValid = true;
+			update.hextileX = 0;
+			update.hextileY = 0;
+
+			if( rectHeader.encoding == rfbEncodingLastRect )
+			{
+				break;
+			}
 		}
 
-		if( handleRect( buffer, rectHeader ) == false )
+		FramebufferUpdateReader reader( *this, update.pos );
+		if( handleRect( reader, rectHeader ) == false )
 		{
 			return false;
 		}
 
+		update.pos = reader.pos();
+
 		if( isPseudoEncoding( rectHeader ) == false &&
 			rectHeader.r.x+rectHeader.r.w <= m_framebufferWidth &&
 			rectHeader.r.y+rectHeader.r.h <= m_framebufferHeight )
 		{
-			updatedRegion += QRect( rectHeader.r.x, rectHeader.r.y, rectHeader.r.w, rectHeader.r.h );
+			update.updatedRegion += QRect( rectHeader.r.x, rectHeader.r.y, rectHeader.r.w, rectHeader.r.h );
 		}
+
+		update.rectHeaderValid = false;
+		++update.rectIndex;
 	}
 
-	m_lastUpdatedRect = updatedRegion.boundingRect();
+	update.message.truncate( update.pos );
+
+	// let the hint decay after large updates so that the buffers do not grow without bounds
+	m_framebufferUpdateSizeHint = std::min( std::max( update.pos, ( m_framebufferUpdateSizeHint + update.pos ) / 2 ),
+											int(MaximumFramebufferUpdateSizeHint) );
+
+	// hand the message over without sharing it and continue with the buffer of the previous
+	// message so that neither of both has to be reallocated for the next update
+	m_lastMessage.swap( update.message );
+	m_lastUpdatedRect = update.updatedRegion.boundingRect();
+
+	// truncate() (unlike clear()) keeps the allocated capacity
+	update.message.truncate( 0 );
+	update.pos = 0;
+	update.rectCount = -1;
+	update.rectIndex = 0;
+	update.rectHeaderValid = false;
+	update.updatedRegion = {};
 
-	// save as much data as we read by processing rects
-	return readMessage( static_cast<int>( buffer.pos() ) );
+	return true;
 }
 
 
@@ -567,7 +628,69 @@ bool VncClientProtocol::readMessage( int size )
 
 
 
-bool VncClientProtocol::handleRect( QBuffer& buffer, rfbFramebufferUpdateRectHeader rectHeader )
+bool VncClientProtocol::FramebufferUpdateReader::read( void* data, int size ) // Flawfinder: ignore
+{
+	if( fetch( size ) == false )
+	{
+		return false;
+	}
+
+	memcpy( data, m_protocol.m_framebufferUpdate.message.constData() + m_pos, size_t(size) ); // Flawfinder: ignore
+	m_pos += size;
+
+	return true;
+}
+
+
+
+bool VncClientProtocol::FramebufferUpdateReader::skip( qint64 size )
+{
+	if( size < 0 || fetch( size ) == false )
+	{
+		return false;
+	}
+
+	m_pos += static_cast<int>( size );
+
+	return true;
+}
+
+
+
+bool VncClientProtocol::FramebufferUpdateReader::fetch( qint64 size )
+{
+	auto& message = m_protocol.m_framebufferUpdate.message;
+	auto socket = m_protocol.m_socket;
+
+	const auto requiredSize = m_pos + size;
+	if( requiredSize <= message.size() )
+	{
+		return true;
+	}
+
+	if( requiredSize > MaximumMessageSize )
+	{
+		vCritical() << "Message too big or invalid";
+		socket->close();
+		return false;
+	}
+
+	const auto bytesToRead = std::min( requiredSize - message.size(), socket->bytesAvailable() );
+	if( bytesToRead > 0 )
+	{
+		const auto oldSize = message.size();
+		message.resize( static_cast<int>( oldSize + bytesToRead ) );
+
+		const auto bytesRead = socket->read( message.data() + oldSize, bytesToRead ); // Flawfinder: ignore
+		message.resize( static_cast<int>( oldSize + std::max<qint64>( 0, bytesRead ) ) );
+	}
+
+	return requiredSize <= message.size();
+}
+
+
+
+bool VncClientProtocol::handleRect( FramebufferUpdateReader& reader, rfbFramebufferUpdateRectHeader rectHeader )
 {
 	const uint width = rectHeader.r.w;
 	const uint height = rectHeader.r.h;
@@ -582,51 +705,51 @@ bool VncClientProtocol::handleRect( QBuffer& buffer, rfbFramebufferUpdateRectHea
 
 	case rfbEncodingXCursor:
 		return width * height == 0 ||
-				( buffer.read( sz_rfbXCursorColors ).size() == sz_rfbXCursorColors &&
-				  buffer.read( size_t(2) * bytesPerRow * height ).size() == static_cast<int>( 2 * bytesPerRow * height ) );
+				( reader.skip( sz_rfbXCursorColors ) &&
+				  reader.skip( qint64(2) * bytesPerRow * height ) );
 
 	case rfbEncodingRichCursor:
 		return width * height == 0 ||
-				( buffer.read( size_t(width) * height * bytesPerPixel ).size() == static_cast<int>( width * height * bytesPerPixel ) &&
-				  buffer.read( size_t(bytesPerRow) * height ).size() == static_cast<int>( bytesPerRow * height ) );
+				( reader.skip( qint64(width) * height * bytesPerPixel ) &&
+				  reader.skip( qint64(bytesPerRow) * height ) );
 
 	case rfbEncodingSupportedMessages:
-		return buffer.read( sz_rfbSupportedMessages ).size() == sz_rfbSupportedMessages;
+		return reader.skip( sz_rfbSupportedMessages );
 
 	case rfbEncodingSupportedEncodings:
 	case rfbEncodingServerIdentity:
 		// width = byte count
-		return buffer.read( width ).size() == static_cast<int>( width );
+		return reader.skip( width );
 
 	case rfbEncodingRaw:
-		return buffer.read( size_t(width) * height * bytesPerPixel ).size() == static_cast<int>( width * height * bytesPerPixel );
+		return reader.skip( qint64(width) * height * bytesPerPixel );
 
 	case rfbEncodingCopyRect:
-		return buffer.read( sz_rfbCopyRect ).size() == sz_rfbCopyRect;
+		return reader.skip( sz_rfbCopyRect );
 
 	case rfbEncodingRRE:
-		return handleRectEncodingRRE( buffer, bytesPerPixel );
+		return handleRectEncodingRRE( reader, bytesPerPixel );
 
 	case rfbEncodingCoRRE:
-		return handleRectEncodingCoRRE( buffer, bytesPerPixel );
+		return handleRectEncodingCoRRE( reader, bytesPerPixel );
 
 	case rfbEncodingHextile:
-		return handleRectEncodingHextile( buffer, rectHeader, bytesPerPixel );
+		return handleRectEncodingHextile( reader, rectHeader, bytesPerPixel );
 
 	case rfbEncodingUltra:
 	case rfbEncodingUltraZip:
 	case rfbEncodingZlib:
-		return handleRectEncodingZlib( buffer );
+		return handleRectEncodingZlib( reader );
 
 	case rfbEncodingZRLE:
 	case rfbEncodingZYWRLE:
-		return handleRectEncodingZRLE( buffer );
+		return handleRectEncodingZRLE( reader );
 
 	case rfbEncodingTight:
-		return handleRectEncodingTight(buffer, rectHeader);
+		return handleRectEncodingTight(reader, rectHeader);
 
 	case rfbEncodingExtDesktopSize:
-		return handleRectEncodingExtDesktopSize(buffer);
+		return handleRectEncodingExtDesktopSize(reader);
 
 	case rfbEncodingPointerPos:
 	case rfbEncodingKeyboardLedState:
@@ -645,11 +768,11 @@ bool VncClientProtocol::handleRect( QBuffer& buffer, rfbFramebufferUpdateRectHea
 
 
 
-bool VncClientProtocol::handleRectEncodingRRE( QBuffer& buffer, uint bytesPerPixel )
+bool VncClientProtocol::handleRectEncodingRRE( FramebufferUpdateReader& reader, uint bytesPerPixel )
 {
 	rfbRREHeader hdr;
 
-	if( buffer.read( reinterpret_cast<char *>( &hdr ), sz_rfbRREHeader ) != sz_rfbRREHeader )
+	if( reader.read( &hdr, sz_rfbRREHeader ) == false ) // Flawfinder: ignore
 	{
 		return false;
 	}
@@ -657,16 +780,16 @@ bool VncClientProtocol::handleRectEncodingRRE( QBuffer& buffer, uint bytesPerPix
 	const auto rectDataSize = qFromBigEndian( hdr.nSubrects ) * ( bytesPerPixel + sz_rfbRectangle );
 	const auto totalDataSize = static_cast<int>( bytesPerPixel + rectDataSize );
 
-	return totalDataSize < MaxMessageSize && buffer.read( totalDataSize ).size() == totalDataSize;
+	return totalDataSize < MaxMessageSize && reader.skip( totalDataSize );
 }
 
 
 
-bool VncClientProtocol::handleRectEncodingCoRRE( QBuffer& buffer, uint bytesPerPixel )
+bool VncClientProtocol::handleRectEncodingCoRRE( FramebufferUpdateReader& reader, uint bytesPerPixel )
 {
 	rfbRREHeader hdr;
 
-	if( buffer.read( reinterpret_cast<char *>( &hdr ), sz_rfbRREHeader ) != sz_rfbRREHeader )
+	if( reader.read( &hdr, sz_rfbRREHeader ) == false ) // Flawfinder: ignore
 	{
 		return false;
 	}
@@ -674,142 +797,129 @@ bool VncClientProtocol::handleRectEncodingCoRRE( QBuffer& buffer, uint bytesPerP
 	const auto rectDataSize = qFromBigEndian( hdr.nSubrects ) * ( bytesPerPixel + 4 );
 	const auto totalDataSize = static_cast<int>( bytesPerPixel + rectDataSize );
 
-	return totalDataSize < MaxMessageSize && buffer.read( totalDataSize ).size() == totalDataSize;
+	return totalDataSize < MaxMessageSize && reader.skip( totalDataSize );
 
 }
 
 
 
-bool VncClientProtocol::handleRectEncodingHextile( QBuffer& buffer,
+bool VncClientProtocol::handleRectEncodingHextile( FramebufferUpdateReader& reader,
 												   const rfbFramebufferUpdateRectHeader rectHeader,
 												   uint bytesPerPixel )
 {
-	const uint rx = rectHeader.r.x;
-	const uint ry = rectHeader.r.y;
 	const uint rw = rectHeader.r.w;
 	const uint rh = rectHeader.r.h;
 
-	for( uint y = ry; y < ry+rh; y += 16 )
+	// a single hextile rect can consist of thousands of tiles so remember
+	// the last completely parsed tile and continue from there next time
+	auto& update = m_framebufferUpdate;
+
+	for( ; update.hextileY < rh; update.hextileY += 16, update.hextileX = 0 )
 	{
-		for( uint x = rx; x < rx+rw; x += 16 )
+		for( ; update.hextileX < rw; update.hextileX += 16 )
 		{
-			uint w = 16, h = 16;
-			if( rx+rw - x < 16 )
-			{
-				w = rx+rw - x;
-			}
-			if( ry+rh - y < 16 )
-			{
-				h = ry+rh - y;
-			}
+			const auto w = std::min<uint>( 16, rw - update.hextileX );
+			const auto h = std::min<uint>( 16, rh - update.hextileY );
 
-			uint8_t subEncoding = 0;
-			if( buffer.read( reinterpret_cast<char *>( &subEncoding ), 1 ) != 1 )
+			if( handleHextileTile( reader, w, h, bytesPerPixel ) == false )
 			{
 				return false;
 			}
 
-			if( subEncoding & rfbHextileRaw )
-			{
-				const auto dataSize = static_cast<int>( w * h * bytesPerPixel );
-				if( buffer.read( dataSize ).size() != dataSize )
-				{
-					return false;
-				}
-				continue;
-			}
+			update.pos = reader.pos();
+		}
+	}
 
-			if( subEncoding & rfbHextileBackgroundSpecified )
-			{
-				if( buffer.read( bytesPerPixel ).size() != static_cast<int>( bytesPerPixel ) )
-				{
-					return false;
-				}
-			}
+	return true;
+}
 
-			if( subEncoding & rfbHextileForegroundSpecified )
-			{
-				if( buffer.read( bytesPerPixel ).size() != static_cast<int>( bytesPerPixel ) )
-				{
-					return false;
-				}
-			}
 
-			if( !( subEncoding & rfbHextileAnySubrects ) )
-			{
-				continue;
-			}
 
-			uint8_t nSubrects = 0;
-			if( buffer.read( reinterpret_cast<char *>( &nSubrects ), 1 ) != 1 )
-			{
-				return false;
-			}
+bool VncClientProtocol::handleHextileTile( FramebufferUpdateReader& reader, uint w, uint h, uint bytesPerPixel )
+{
+	uint8_t subEncoding = 0;
+	if( reader.read( &subEncoding, 1 ) == false ) // Flawfinder: ignore
+	{
+		return false;
+	}
 
-			int subRectDataSize = 0;
+	if( subEncoding & rfbHextileRaw )
+	{
+		return reader.skip( qint64(w) * h * bytesPerPixel );
+	}
 
-			if( subEncoding & rfbHextileSubrectsColoured )
-			{
-				subRectDataSize = static_cast<int>( nSubrects * ( 2 + bytesPerPixel ) );
-			}
-			else
-			{
-				subRectDataSize = nSubrects * 2;
-			}
+	if( ( subEncoding & rfbHextileBackgroundSpecified ) && reader.skip( bytesPerPixel ) == false )
+	{
+		return false;
+	}
 
-			if( buffer.read( subRectDataSize ).size() != subRectDataSize )
-			{
-				return false;
-			}
-		}
+	if( ( subEncoding & rfbHextileForegroundSpecified ) && reader.skip( bytesPerPixel ) == false )
+	{
+		return false;
 	}
 
-	return true;
+	if( !( subEncoding & rfbHextileAnySubrects ) )
+	{
+		return true;
+	}
+
+	uint8_t nSubrects = 0;
+	if( reader.read( &nSubrects, 1 ) == false ) // Flawfinder: ignore
+	{
+		return false;
+	}
+
+	if( subEncoding & rfbHextileSubrectsColoured )
+	{
+		return reader.skip( nSubrects * ( 2 + bytesPerPixel ) );
+	}
+
+	return reader.skip( nSubrects * 2 );
 }
 
 
 
-bool VncClientProtocol::handleRectEncodingZlib( QBuffer& buffer )
+bool VncClientProtocol::handleRectEncodingZlib( FramebufferUpdateReader& reader )
 {
 	rfbZlibHeader hdr;
 
-	if( buffer.read( reinterpret_cast<char *>( &hdr ), sz_rfbZlibHeader ) != sz_rfbZlibHeader )
+	if( reader.read( &hdr, sz_rfbZlibHeader ) == false ) // Flawfinder: ignore
 	{
 		return false;
 	}
 
 	const auto n = qFromBigEndian( hdr.nBytes );
 
-	return n < MaxMessageSize && uint32_t(buffer.read(n).size()) == n;
+	return n < MaxMessageSize && reader.skip( n );
 }
 
 
 
-bool VncClientProtocol::handleRectEncodingZRLE(QBuffer &buffer)
+bool VncClientProtocol::handleRectEncodingZRLE( FramebufferUpdateReader& reader )
 {
 	rfbZRLEHeader hdr;
 
-	if( buffer.read( reinterpret_cast<char *>( &hdr ), sz_rfbZRLEHeader ) != sz_rfbZRLEHeader )
+	if( reader.read( &hdr, sz_rfbZRLEHeader ) == false ) // Flawfinder: ignore
 	{
 		return false;
 	}
 
 	const auto n = qFromBigEndian( hdr.length );
 
-	return n < MaxMessageSize && uint32_t(buffer.read(n).size()) == n;
+	return n < MaxMessageSize && reader.skip( n );
 }
 
 
 
-bool VncClientProtocol::handleRectEncodingTight(QBuffer& buffer,
+bool VncClientProtocol::handleRectEncodingTight(FramebufferUpdateReader& reader,
 												const rfbFramebufferUpdateRectHeader rectHeader)
 {
-	static const auto readCompactLength = [](QBuffer& buffer) -> int64_t
+	static const auto readCompactLength = [](FramebufferUpdateReader& reader) -> int64_t
 	{
 		int64_t len;
 		uint8_t b;
 
-		if (buffer.read(reinterpret_cast<char *>(&b), 1 ) != 1)
+		if (reader.read(&b, 1) == false) // Flawfinder: ignore
 		{
 			return -1;
 		}
@@ -818,7 +928,7 @@ bool VncClientProtocol::handleRectEncodingTight(QBuffer& buffer,
 
 		if (b & 0x80)
 		{
-			if (buffer.read(reinterpret_cast<char *>(&b), 1) != 1)
+			if (reader.read(&b, 1) == false) // Flawfinder: ignore
 			{
 				return -1;
 			}
@@ -827,7 +937,7 @@ bool VncClientProtocol::handleRectEncodingTight(QBuffer& buffer,
 
 			if (b & 0x80)
 			{
-				if (buffer.read(reinterpret_cast<char *>(&b), 1) != 1)
+				if (reader.read(&b, 1) == false) // Flawfinder: ignore
 				{
 					return -1;
 				}
@@ -852,7 +962,7 @@ bool VncClientProtocol::handleRectEncodingTight(QBuffer& buffer,
 	const auto bytesPerPixel = bitsPerPixel / 8;
 
 	uint8_t compCtl = 255;
-	if (buffer.read(reinterpret_cast<char *>(&compCtl), 1) != 1)
+	if (reader.read(&compCtl, 1) == false) // Flawfinder: ignore
 	{
 		return false;
 	}
@@ -866,13 +976,12 @@ bool VncClientProtocol::handleRectEncodingTight(QBuffer& buffer,
 
 	if (compCtl == rfbTightFill)
 	{
-		return buffer.read(bytesPerPixel).size() == bytesPerPixel;
+		return reader.skip(bytesPerPixel);
 	}
 
 	if (compCtl == rfbTightJpeg)
 	{
-		const auto dataLength = readCompactLength(buffer);
-		return buffer.read(dataLength).size() == dataLength;
+		return reader.skip(readCompactLength(reader));
 	}
 
 	if (compCtl > rfbTightMaxSubencoding)
@@ -884,7 +993,7 @@ bool VncClientProtocol::handleRectEncodingTight(QBuffer& buffer,
 	if (compCtl & rfbTightExplicitFilter)
 	{
 		uint8_t filterId = 0;
-		if (buffer.read(reinterpret_cast<char *>(&filterId), 1) != 1)
+		if (reader.read(&filterId, 1) == false) // Flawfinder: ignore
 		{
 			return false;
 		}
@@ -896,7 +1005,7 @@ bool VncClientProtocol::handleRectEncodingTight(QBuffer& buffer,
 		case rfbTightFilterPalette:
 		{
 			uint8_t numColors;
-			if (buffer.read(reinterpret_cast<char *>(&numColors), 1) != 1)
+			if (reader.read(&numColors, 1) == false) // Flawfinder: ignore
 			{
 				return false;
 			}
@@ -905,8 +1014,7 @@ bool VncClientProtocol::handleRectEncodingTight(QBuffer& buffer,
 			{
 				return false;
 			}
-			const auto rectBytes = tightRectColors * bytesPerPixel;
-			if (buffer.read(rectBytes).size() != rectBytes)
+			if (reader.skip(tightRectColors * bytesPerPixel) == false)
 			{
 				return false;
 			}
@@ -927,36 +1035,30 @@ bool VncClientProtocol::handleRectEncodingTight(QBuffer& buffer,
 	const int uncompressedRectSize = rectHeader.r.h * rowSize;
 	if (uncompressedRectSize < MaximumUncompressedSize)
 	{
-		return buffer.read(uncompressedRectSize).size() == uncompressedRectSize;
+		return reader.skip(uncompressedRectSize);
 	}
 
-	const auto compressedLength = readCompactLength(buffer);
-	if (compressedLength <= 0)
+	const auto compressedLength = readCompactLength(reader);
+	if (compressedLength == 0)
 	{
 		vWarning() << "bad compressed length received";
 		return false;
 	}
 
-	return buffer.read(compressedLength).size() == compressedLength;
+	return reader.skip(compressedLength);
 }
 
 
 
-bool VncClientProtocol::handleRectEncodingExtDesktopSize(QBuffer& buffer)
+bool VncClientProtocol::handleRectEncodingExtDesktopSize(FramebufferUpdateReader& reader)
 {
 	rfbExtDesktopSizeMsg extDesktopSizeMsg;
-	if (buffer.peek(reinterpret_cast<char *>(&extDesktopSizeMsg), sz_rfbExtDesktopSizeMsg) != sz_rfbExtDesktopSizeMsg)
+	if (reader.read(&extDesktopSizeMsg, sz_rfbExtDesktopSizeMsg) == false) // Flawfinder: ignore
 	{
 		return false;
 	}
 
-	const auto totalMessageSize = sz_rfbExtDesktopSizeMsg + extDesktopSizeMsg.numberOfScreens * sz_rfbExtDesktopScreen;
-	if (buffer.bytesAvailable() >= totalMessageSize)
-	{
-		return buffer.read(totalMessageSize).size() == totalMessageSize;
-	}
-
-	return false;
+	return reader.skip(extDesktopSizeMsg.numberOfScreens * sz_rfbExtDesktopScreen);
 }
 
 
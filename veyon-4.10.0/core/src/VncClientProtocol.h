@@ -24,13 +24,12 @@
 
 #pragma once
 
-#include <QRect>
+#include <QRegion>
 
 #include "rfb/rfbproto.h"
 
 #include "CryptoCore.h"
 
-class QBuffer;
 class QIODevice;
 
 class VEYON_CORE_EXPORT VncClientProtocol
@@ -82,6 +81,8 @@ public:
 
 	void requestFramebufferUpdate( bool incremental );
 
+	bool sendFramebufferScale( uint8_t scale );
+
 	bool receiveMessage();
 
 	const QByteArray& lastMessage() const
@@ -123,21 +124,48 @@ private:
 
 	bool readMessage( int size );
 
-	bool handleRect( QBuffer& buffer, rfbFramebufferUpdateRectHeader rectHeader );
-	bool handleRectEncodingRRE( QBuffer& buffer, uint bytesPerPixel );
-	bool handleRectEncodingCoRRE( QBuffer& buffer, uint bytesPerPixel );
-	bool handleRectEncodingHextile( QBuffer& buffer,
+	// reads framebuffer update data from the socket on demand while parsing it without copying
+	class FramebufferUpdateReader
+	{
+	public:
+		FramebufferUpdateReader( VncClientProtocol& protocol, int pos ) :
+			m_protocol( protocol ),
+			m_pos( pos )
+		{
+		}
+
+		int pos() const
+		{
+			return m_pos;
+		}
+
+		bool read( void* data, int size ); // Flawfinder: ignore
+		bool skip( qint64 size );
+
+	private:
+		bool fetch( qint64 size );
+
+		VncClientProtocol& m_protocol;
+		int m_pos;
+	} ;
+
+	bool handleRect( FramebufferUpdateReader& reader, rfbFramebufferUpdateRectHeader rectHeader );
+	bool handleRectEncodingRRE( FramebufferUpdateReader& reader, uint bytesPerPixel );
+	bool handleRectEncodingCoRRE( FramebufferUpdateReader& reader, uint bytesPerPixel );
+	bool handleRectEncodingHextile( FramebufferUpdateReader& reader,
 									const rfbFramebufferUpdateRectHeader rectHeader,
 									uint bytesPerPixel );
-	bool handleRectEncodingZlib( QBuffer& buffer );
-	bool handleRectEncodingZRLE( QBuffer& buffer );
-	bool handleRectEncodingTight(QBuffer& buffer,
+	bool handleHextileTile( FramebufferUpdateReader& reader, uint w, uint h, uint bytesPerPixel );
+	bool handleRectEncodingZlib( FramebufferUpdateReader& reader );
+	bool handleRectEncodingZRLE( FramebufferUpdateReader& reader );
+	bool handleRectEncodingTight(FramebufferUpdateReader& reader,
 								 const rfbFramebufferUpdateRectHeader rectHeader);
-	bool handleRectEncodingExtDesktopSize(QBuffer& buffer);
+	bool handleRectEncodingExtDesktopSize(FramebufferUpdateReader& reader);
 
 	static bool isPseudoEncoding( rfbFramebufferUpdateRectHeader header );
 
 	static constexpr auto MaximumMessageSize = 4096*4096*4;
+	static constexpr auto MaximumFramebufferUpdateSizeHint = 4*1024*1024;
 
 	QIODevice* m_socket;
 	State m_state;
@@ -154,5 +182,20 @@ private:
 
 	QByteArray m_lastMessage;
 	QRect m_lastUpdatedRect;
+	int m_framebufferUpdateSizeHint{0};
+
+	// state of a partially received framebuffer update message
+	struct FramebufferUpdateState
+	{
+		QByteArray message{};
+		int pos{0};
+		int rectCount{-1};
+		int rectIndex{0};
+		bool rectHeaderValid{false};
+		rfbFramebufferUpdateRectHeader rectHeader{};
+		uint hextileX{0};
+		uint hextileY{0};
+		QRegion updatedRegion{};
+	} m_framebufferUpdate{};
 
 } ;
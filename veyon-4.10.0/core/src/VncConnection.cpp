@@ -37,10 +37,88 @@
 #include "PlatformNetworkFunctions.h"
 #include "VeyonConfiguration.h"
 #include "VncConnection.h"
+#include "VncConnectionEngine.h"
 #include "SocketDevice.h"
 #include "VncEvents.h"
 
 
+// downscales the area of source which corresponds to targetRect in target using an integer box
+// filter, i.e. each target pixel is the average of all source pixels it covers
+static void boxScaleImage(const QImage& source, QImage& target, const QRect& targetRect)
+{
+	const auto sourceWidth = source.width();
+	const auto sourceHeight = source.height();
+	const auto targetWidth = target.width();
+	const auto targetHeight = target.height();
+
+	// first source column/row covered by a target column/row (each one covers at least one)
+	const auto sourceColumn = [=](int x) {
+		return std::min(int(qint64(x) * sourceWidth / targetWidth), sourceWidth);
+	};
+	const auto sourceRow = [=](int y) {
+		return std::min(int(qint64(y) * sourceHeight / targetHeight), sourceHeight);
+	};
+
+	// source column span of each target column, relative to the first source column involved
+	const auto firstColumn = std::min(sourceColumn(targetRect.left()), sourceWidth - 1);
+	std::vector<int> columnBegin(size_t(targetRect.width()));
+	std::vector<int> columnEnd(size_t(targetRect.width()));
+	for (int i = 0; i < targetRect.width(); ++i)
+	{
+		const auto x = targetRect.left() + i;
+		const auto begin = std::min(sourceColumn(x), sourceWidth - 1);
+		columnBegin[size_t(i)] = begin - firstColumn;
+		columnEnd[size_t(i)] = std::max(sourceColumn(x + 1), begin + 1) - firstColumn;
+	}
+
+	// per-channel column sums kept in separate arrays so that the inner loops vectorize
+	const auto columnCount = size_t(columnEnd.back());
+	std::vector<uint32_t> red(columnCount);
+	std::vector<uint32_t> green(columnCount);
+	std::vector<uint32_t> blue(columnCount);
+
+	for (int y = targetRect.top(); y <= targetRect.bottom(); ++y)
+	{
+		const auto rowBegin = std::min(sourceRow(y), sourceHeight - 1);
+		const auto rowEnd = std::max(sourceRow(y + 1), rowBegin + 1);
+
+		std::fill(red.begin(), red.end(), 0);
+		std::fill(green.begin(), green.end(), 0);
+		std::fill(blue.begin(), blue.end(), 0);
+
+		for (int row = rowBegin; row < rowEnd; ++row)
+		{
+			const auto sourcePixels = reinterpret_cast<const QRgb *>(source.constScanLine(row)) + firstColumn;
+			for (size_t column = 0; column < columnCount; ++column)
+			{
+				const auto pixel = sourcePixels[column];
+				red[column] += (pixel >> 16) & 0xff;
+				green[column] += (pixel >> 8) & 0xff;
+				blue[column] += pixel & 0xff;
+			}
+		}
+
+		const auto rowCount = uint32_t(rowEnd - rowBegin);
+		auto targetPixels = reinterpret_cast<QRgb *>(target.scanLine(y)) + targetRect.left();
+
+		for (size_t i = 0; i < columnBegin.size(); ++i)
+		{
+			uint32_t r = 0, g = 0, b = 0;
+			for (auto column = size_t(columnBegin[i]); column < size_t(columnEnd[i]); ++column)
+			{
+				r += red[column];
+				g += green[column];
+				b += blue[column];
+			}
+
+			const auto count = rowCount * uint32_t(columnEnd[i] - columnBegin[i]);
+			targetPixels[i] = qRgb(int(r / count), int(g / count), int(b / count));
+		}
+	}
+}
+
+
+
 rfbBool VncConnection::hookInitFrameBuffer( rfbClient* client )
 {
 	auto connection = static_cast<VncConnection *>( clientData( client, VncConnectionTag ) );
@@ -60,6 +138,11 @@ void VncConnection::hookUpdateFB( rfbClient* client, int x, int y, int w, int h
 	auto connection = static_cast<VncConnection *>( clientData( client, VncConnectionTag ) );
 	if( connection )
 	{
+		if (connection->isThumbnailMode())
+		{
+			connection->m_dirtyRegion += QRect(x, y, w, h);
+		}
+
 		Q_EMIT connection->imageUpdated( x, y, w, h );
 	}
 }
@@ -197,6 +280,11 @@ VncConnection::VncConnection( QObject* parent ) :
 
 VncConnection::~VncConnection()
 {
+	if (m_managedByEngine)
+	{
+		VncConnectionEngine::instance()->detach(this);
+	}
+
 	if( isRunning() )
 	{
 		vWarning() << "Waiting for VNC connection thread to finish.";
@@ -240,14 +328,23 @@ QImage VncConnection::image()
 
 void VncConnection::restart()
 {
-	if (isRunning())
+	if (isActive())
 	{
 		setControlFlag(ControlFlag::RestartConnection, true);
+		wakeUp();
 	}
 	else
 	{
 		setControlFlag(ControlFlag::TerminateThread, false);
-		start();
+
+		if (VncConnectionEngine::isEnabled())
+		{
+			VncConnectionEngine::instance()->attach(this);
+		}
+		else
+		{
+			start();
+		}
 	}
 }
 
@@ -257,18 +354,20 @@ void VncConnection::stop()
 {
 	setClientData( VncConnectionTag, nullptr );
 
+	m_scaledFramebufferMutex.lock();
 	m_scaledFramebuffer = {};
+	m_scaledFramebufferMutex.unlock();
 
 	setControlFlag( ControlFlag::TerminateThread, true );
 
-	m_updateIntervalSleeper.wakeAll();
+	wakeUp();
 }
 
 
 
 void VncConnection::stopAndDeleteLater()
 {
-	if( isRunning() )
+	if( isActive() )
 	{
 		setControlFlag( ControlFlag::DeleteAfterFinished, true );
 		stop();
@@ -383,12 +482,38 @@ void VncConnection::setScaledSize( QSize s )
 
 QImage VncConnection::scaledFramebuffer()
 {
-	rescaleFramebuffer();
+	QMutexLocker locker(&m_scaledFramebufferMutex);
+
+	// in thumbnail mode the scaled framebuffer is maintained by the connection thread and only
+	// has to be (re)built here initially or after the scaled size has changed
+	if (isThumbnailMode() == false ||
+		isControlFlagSet(ControlFlag::ScaledFramebufferNeedsUpdate) ||
+		m_scaledFramebuffer.size() != m_scaledSize)
+	{
+		locker.unlock();
+		rescaleFramebuffer();
+		locker.relock();
+	}
+
 	return m_scaledFramebuffer;
 }
 
 
 
+void VncConnection::setThumbnailMode(bool on)
+{
+	if (isThumbnailMode() != on)
+	{
+		setControlFlag(ControlFlag::ThumbnailMode, on);
+
+		// rebuild scaled framebuffer from scratch as it may be outdated when entering thumbnail mode
+		// and is not updated on the connection thread anymore when leaving it
+		setControlFlag(ControlFlag::ScaledFramebufferNeedsUpdate, true);
+	}
+}
+
+
+
 void VncConnection::setFramebufferUpdateInterval( int interval )
 {
 	m_framebufferUpdateInterval = interval;
@@ -400,7 +525,19 @@ void VncConnection::setFramebufferUpdateInterval( int interval )
 			setControlFlag(ControlFlag::TriggerFramebufferUpdate, true);
 		}
 
-		m_updateIntervalSleeper.wakeAll();
+		wakeUp();
+	}
+}
+
+
+
+void VncConnection::requestFullFramebufferUpdate()
+{
+	if (state() == State::Connected)
+	{
+		setControlFlag(ControlFlag::TriggerFullFramebufferUpdate, true);
+
+		wakeUp();
 	}
 }
 
@@ -408,8 +545,9 @@ void VncConnection::setFramebufferUpdateInterval( int interval )
 
 void VncConnection::rescaleFramebuffer()
 {
-	if( hasValidFramebuffer() == false || m_scaledSize.isNull() )
+	if( hasValidFramebuffer() == false || m_scaledSize.isEmpty() )
 	{
+		QMutexLocker locker(&m_scaledFramebufferMutex);
 		m_scaledFramebuffer = {};
 		return;
 	}
@@ -426,9 +564,24 @@ void VncConnection::rescaleFramebuffer()
 		return;
 	}
 
-	m_scaledFramebuffer = m_image.scaled( m_scaledSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation );
+	// hold the lock while rebuilding so that dirty regions scaled on the connection thread in the
+	// meantime are not overwritten with outdated content of the rebuilt image
+	QMutexLocker scaledFramebufferLocker(&m_scaledFramebufferMutex);
 
 	setControlFlag( ControlFlag::ScaledFramebufferNeedsUpdate, false );
+
+	// use the same filter as for incremental updates of dirty regions so that both blend seamlessly
+	QImage scaledFramebuffer(m_scaledSize, QImage::Format_RGB32);
+	boxScaleImage(m_image, scaledFramebuffer, scaledFramebuffer.rect());
+
+	m_scaledFramebuffer = scaledFramebuffer;
+}
+
+
+
+VncConnection::Statistics VncConnection::takeStatistics()
+{
+	return {m_decodeTime.exchange(0), m_framebufferUpdateCount.exchange(0)};
 }
 
 
@@ -468,10 +621,7 @@ void VncConnection::run()
 		handleConnection();
 		closeConnection();
 
-		const auto minimumConnectionTime = m_framebufferUpdateInterval > 0 ?
-											   int(m_framebufferUpdateInterval) :
-											   m_connectionRetryInterval;
-		QThread::msleep(std::max<int>(0, minimumConnectionTime - connectionTimer.elapsed()));
+		QThread::msleep(std::max<int>(0, connectionRetryInterval() - connectionTimer.elapsed()));
 	}
 
 	if( isControlFlagSet( ControlFlag::DeleteAfterFinished ) )
@@ -486,123 +636,133 @@ void VncConnection::establishConnection()
 {
 	QMutex sleeperMutex;
 
-	setState( State::Connecting );
-	setControlFlag( ControlFlag::RestartConnection, false );
-
-	m_framebufferState = FramebufferState::Invalid;
+	prepareConnection();
 
 	while( isControlFlagSet( ControlFlag::TerminateThread ) == false &&
 		   state() != State::Connected ) // try to connect as long as the server allows
 	{
-		m_globalMutex.lock();
-		m_client = rfbGetClient( RfbBitsPerSample, RfbSamplesPerPixel, RfbBytesPerPixel );
-		m_client->MallocFrameBuffer = hookInitFrameBuffer;
-		m_client->canHandleNewFBSize = true;
-		m_client->GotFrameBufferUpdate = hookUpdateFB;
-		m_client->FinishedFrameBufferUpdate = hookFinishFrameBufferUpdate;
-		m_client->HandleCursorPos = hookHandleCursorPos;
-		m_client->GotCursorShape = hookCursorShape;
-		m_client->GotXCutText = hookCutText;
-		m_client->connectTimeout = m_connectTimeout / 1000;
-		m_client->readTimeout = m_readTimeout / 1000;
-		m_globalMutex.unlock();
+		if (connectToServer() == false &&
+			isControlFlagSet(ControlFlag::TerminateThread) == false)
+		{
+			// wait a bit until next connect
+			sleeperMutex.lock();
+			m_updateIntervalSleeper.wait(&sleeperMutex, connectionRetryInterval());
+			sleeperMutex.unlock();
+		}
+	}
+}
 
-		setClientData( VncConnectionTag, this );
 
-		Q_EMIT connectionPrepared();
 
-		m_globalMutex.lock();
+void VncConnection::prepareConnection()
+{
+	setState( State::Connecting );
+	setControlFlag( ControlFlag::RestartConnection, false );
 
-		if( m_port < 0 ) // use default port?
-		{
-			m_client->serverPort = m_defaultPort;
-		}
-		else
-		{
-			m_client->serverPort = m_port;
-		}
+	m_framebufferState = FramebufferState::Invalid;
+}
 
-		free( m_client->serverHost );
-		m_client->serverHost = strdup( m_host.toUtf8().constData() );
 
-		m_globalMutex.unlock();
 
-		setControlFlag( ControlFlag::ServerReachable, false );
+bool VncConnection::connectToServer()
+{
+	m_globalMutex.lock();
+	m_client = rfbGetClient( RfbBitsPerSample, RfbSamplesPerPixel, RfbBytesPerPixel );
+	m_client->MallocFrameBuffer = hookInitFrameBuffer;
+	m_client->canHandleNewFBSize = true;
+	m_client->GotFrameBufferUpdate = hookUpdateFB;
+	m_client->FinishedFrameBufferUpdate = hookFinishFrameBufferUpdate;
+	m_client->HandleCursorPos = hookHandleCursorPos;
+	m_client->GotCursorShape = hookCursorShape;
+	m_client->GotXCutText = hookCutText;
+	m_client->connectTimeout = m_connectTimeout / 1000;
+	m_client->readTimeout = m_readTimeout / 1000;
+	m_globalMutex.unlock();
+
+	setClientData( VncConnectionTag, this );
+
+	Q_EMIT connectionPrepared();
+
+	m_globalMutex.lock();
+
+	if( m_port < 0 ) // use default port?
+	{
+		m_client->serverPort = m_defaultPort;
+	}
+	else
+	{
+		m_client->serverPort = m_port;
+	}
 
-		const auto clientInitialized = rfbInitClient( m_client, nullptr, nullptr );
-		if( clientInitialized == FALSE )
-		{
-			// rfbInitClient() calls rfbClientCleanup() when failed
-			m_client = nullptr;
-		}
+	free( m_client->serverHost );
+	m_client->serverHost = strdup( m_host.toUtf8().constData() );
 
-		// do not continue/sleep when already requested to stop
-		if( isControlFlagSet( ControlFlag::TerminateThread ) )
-		{
-			return;
-		}
+	m_globalMutex.unlock();
 
-		if( clientInitialized )
-		{
-			m_fullFramebufferUpdateTimer.restart();
-			m_incrementalFramebufferUpdateTimer.restart();
+	setControlFlag( ControlFlag::ServerReachable, false );
 
-			VeyonCore::platform().networkFunctions().
-					configureSocketKeepalive( static_cast<PlatformNetworkFunctions::Socket>( m_client->sock ), true,
-											  m_socketKeepaliveIdleTime, m_socketKeepaliveInterval, m_socketKeepaliveCount );
+	const auto clientInitialized = rfbInitClient( m_client, nullptr, nullptr );
+	if( clientInitialized == FALSE )
+	{
+		// rfbInitClient() calls rfbClientCleanup() when failed
+		m_client = nullptr;
+	}
 
-			setState( State::Connected );
-		}
-		else
-		{
-			// guess reason why connection failed
-			if( isControlFlagSet( ControlFlag::ServerReachable ) == false )
-			{
-				if (isControlFlagSet(ControlFlag::SkipHostPing))
-				{
-					setState(State::HostOffline);
-				}
-				else
-				{
-					const auto pingResult = VeyonCore::platform().networkFunctions().ping(m_host);
-					switch (pingResult)
-					{
-					case PlatformNetworkFunctions::PingResult::ReplyReceived:
-						setState(State::ServerNotRunning);
-						break;
-					case PlatformNetworkFunctions::PingResult::NameResolutionFailed:
-						setState(State::HostNameResolutionFailed);
-						break;
-					default:
-						setState(State::HostOffline);
-					}
-				}
+	// do not continue/sleep when already requested to stop
+	if( isControlFlagSet( ControlFlag::TerminateThread ) )
+	{
+		return false;
+	}
 
-			}
-			else if( m_framebufferState == FramebufferState::Invalid )
-			{
-				setState( State::AuthenticationFailed );
-			}
-			else
-			{
-				// failed for an unknown reason
-				setState( State::ConnectionFailed );
-			}
+	if( clientInitialized )
+	{
+		m_fullFramebufferUpdateTimer.restart();
+		m_incrementalFramebufferUpdateTimer.restart();
 
-			// wait a bit until next connect
-			sleeperMutex.lock();
-			if( m_framebufferUpdateInterval > 0 )
+		VeyonCore::platform().networkFunctions().
+				configureSocketKeepalive( static_cast<PlatformNetworkFunctions::Socket>( m_client->sock ), true,
+										  m_socketKeepaliveIdleTime, m_socketKeepaliveInterval, m_socketKeepaliveCount );
+
+		setState( State::Connected );
+	}
+	else
+	{
+		// guess reason why connection failed
+		if( isControlFlagSet( ControlFlag::ServerReachable ) == false )
+		{
+			if (isControlFlagSet(ControlFlag::SkipHostPing))
 			{
-				m_updateIntervalSleeper.wait( &sleeperMutex, m_framebufferUpdateInterval );
+				setState(State::HostOffline);
 			}
 			else
 			{
-				// default: retry every second
-				m_updateIntervalSleeper.wait( &sleeperMutex, m_connectionRetryInterval );
+				const auto pingResult = VeyonCore::platform().networkFunctions().ping(m_host);
+				switch (pingResult)
+				{
+				case PlatformNetworkFunctions::PingResult::ReplyReceived:
+					setState(State::ServerNotRunning);
+					break;
+				case PlatformNetworkFunctions::PingResult::NameResolutionFailed:
+					setState(State::HostNameResolutionFailed);
+					break;
+				default:
+					setState(State::HostOffline);
+				}
 			}
-			sleeperMutex.unlock();
+
+		}
+		else if( m_framebufferState == FramebufferState::Invalid )
+		{
+			setState( State::AuthenticationFailed );
+		}
+		else
+		{
+			// failed for an unknown reason
+			setState( State::ConnectionFailed );
 		}
 	}
+
+	return state() == State::Connected;
 }
 
 
@@ -612,9 +772,7 @@ void VncConnection::handleConnection()
 	QMutex sleeperMutex;
 	QElapsedTimer loopTimer;
 
-	while( state() == State::Connected &&
-		   isControlFlagSet( ControlFlag::TerminateThread ) == false &&
-		   isControlFlagSet( ControlFlag::RestartConnection ) == false )
+	while (isConnectionAlive())
 	{
 		loopTimer.start();
 
@@ -623,47 +781,15 @@ void VncConnection::handleConnection()
 								   :
 									 (m_framebufferUpdateInterval > 0 ? m_messageWaitTimeout * 100 : m_messageWaitTimeout);
 
-		const int i = WaitForMessage(m_client, waitTimeout);
-
-		if( isControlFlagSet( ControlFlag::TerminateThread ) || i < 0 )
+		if (serviceConnection(waitTimeout) == false)
 		{
 			break;
 		}
-		else if( i )
-		{
-			// handle all available messages
-			bool handledOkay = true;
-			do {
-				handledOkay &= HandleRFBServerMessage( m_client );
-			} while( handledOkay && WaitForMessage( m_client, 0 ) );
 
-			if( handledOkay == false )
-			{
-				break;
-			}
-		}
-		else if (m_fullFramebufferUpdateTimer.elapsed() >= fullFramebufferUpdateTimeout())
-		{
-			requestFrameufferUpdate(FramebufferUpdateType::Full);
-			m_fullFramebufferUpdateTimer.restart();
-		}
-		else if (m_framebufferUpdateInterval > 0 &&
-				 m_incrementalFramebufferUpdateTimer.elapsed() > incrementalFramebufferUpdateTimeout())
-		{
-			requestFrameufferUpdate(FramebufferUpdateType::Incremental);
-			m_incrementalFramebufferUpdateTimer.restart();
-		}
-		else if (isControlFlagSet(ControlFlag::TriggerFramebufferUpdate))
-		{
-			setControlFlag(ControlFlag::TriggerFramebufferUpdate, false);
-			requestFrameufferUpdate(FramebufferUpdateType::Incremental);
-		}
-
-		const auto remainingUpdateInterval = m_framebufferUpdateInterval - loopTimer.elapsed();
+		const auto remainingUpdateInterval = manualUpdateRateControlDelay(loopTimer.elapsed());
 
 		// compat with Veyon Server < 4.7
 		if (remainingUpdateInterval > 0 &&
-			isControlFlagSet(ControlFlag::RequiresManualUpdateRateControl) &&
 			isControlFlagSet(ControlFlag::TerminateThread) == false)
 		{
 			sleeperMutex.lock();
@@ -677,6 +803,98 @@ void VncConnection::handleConnection()
 
 
 
+bool VncConnection::serviceConnection(int waitTimeout)
+{
+	const int i = WaitForMessage(m_client, waitTimeout);
+
+	if( isControlFlagSet( ControlFlag::TerminateThread ) || i < 0 )
+	{
+		return false;
+	}
+
+	if( i )
+	{
+		QElapsedTimer decodeTimer;
+		decodeTimer.start();
+
+		// handle all available messages
+		bool handledOkay = true;
+		do {
+			handledOkay &= HandleRFBServerMessage( m_client );
+		} while( handledOkay && WaitForMessage( m_client, 0 ) );
+
+		m_decodeTime += decodeTimer.nsecsElapsed();
+
+		return handledOkay;
+	}
+
+	if (isControlFlagSet(ControlFlag::TriggerFullFramebufferUpdate) ||
+		m_fullFramebufferUpdateTimer.elapsed() >= fullFramebufferUpdateTimeout())
+	{
+		setControlFlag(ControlFlag::TriggerFullFramebufferUpdate, false);
+		requestFrameufferUpdate(FramebufferUpdateType::Full);
+		m_fullFramebufferUpdateTimer.restart();
+	}
+	else if (m_framebufferUpdateInterval > 0 &&
+			 m_incrementalFramebufferUpdateTimer.elapsed() > incrementalFramebufferUpdateTimeout())
+	{
+		requestFrameufferUpdate(FramebufferUpdateType::Incremental);
+		m_incrementalFramebufferUpdateTimer.restart();
+	}
+	else if (isControlFlagSet(ControlFlag::TriggerFramebufferUpdate))
+	{
+		setControlFlag(ControlFlag::TriggerFramebufferUpdate, false);
+		requestFrameufferUpdate(FramebufferUpdateType::Incremental);
+	}
+
+	return true;
+}
+
+
+
+bool VncConnection::isConnectionAlive()
+{
+	return state() == State::Connected &&
+		   isControlFlagSet(ControlFlag::TerminateThread) == false &&
+		   isControlFlagSet(ControlFlag::RestartConnection) == false;
+}
+
+
+
+bool VncConnection::hasPendingWork()
+{
+	return isConnectionAlive() == false ||
+		   (m_client && m_client->buffered > 0) ||
+		   isEventQueueEmpty() == false ||
+		   isControlFlagSet(ControlFlag::TriggerFramebufferUpdate) ||
+		   isControlFlagSet(ControlFlag::TriggerFullFramebufferUpdate) ||
+		   m_fullFramebufferUpdateTimer.elapsed() >= fullFramebufferUpdateTimeout() ||
+		   (m_framebufferUpdateInterval > 0 &&
+			m_incrementalFramebufferUpdateTimer.elapsed() > incrementalFramebufferUpdateTimeout());
+}
+
+
+
+int VncConnection::manualUpdateRateControlDelay(qint64 elapsed)
+{
+	if (isControlFlagSet(ControlFlag::RequiresManualUpdateRateControl))
+	{
+		return std::max<int>(0, m_framebufferUpdateInterval - elapsed);
+	}
+
+	return 0;
+}
+
+
+
+int VncConnection::connectionRetryInterval() const
+{
+	// default: retry every second
+	return m_framebufferUpdateInterval > 0 ? int(m_framebufferUpdateInterval) : m_connectionRetryInterval;
+}
+
+
+
 void VncConnection::closeConnection()
 {
 	if( m_client )
@@ -789,13 +1007,62 @@ void VncConnection::finishFrameBufferUpdate()
 	m_fullFramebufferUpdateTimer.restart();
 
 	m_framebufferState = FramebufferState::Valid;
-	setControlFlag( ControlFlag::ScaledFramebufferNeedsUpdate, true );
+	++m_framebufferUpdateCount;
+
+	if (isThumbnailMode())
+	{
+		updateScaledFramebuffer();
+	}
+	else
+	{
+		m_dirtyRegion = {};
+		setControlFlag( ControlFlag::ScaledFramebufferNeedsUpdate, true );
+	}
 
 	Q_EMIT framebufferUpdateComplete();
 }
 
 
 
+void VncConnection::updateScaledFramebuffer()
+{
+	const auto dirtyRegion = m_dirtyRegion & m_image.rect();
+	m_dirtyRegion = {};
+
+	m_globalMutex.lock();
+	const auto scaledSize = m_scaledSize;
+	m_globalMutex.unlock();
+
+	QMutexLocker locker(&m_scaledFramebufferMutex);
+
+	// m_image is only modified on this thread, therefore it can be accessed without holding m_imgLock
+	if (dirtyRegion.isEmpty() || m_image.isNull() || scaledSize.isEmpty() ||
+		m_scaledFramebuffer.size() != scaledSize)
+	{
+		// initial scaled framebuffer is created on demand by scaledFramebuffer()
+		return;
+	}
+
+	const auto scaleX = qreal(scaledSize.width()) / m_image.width();
+	const auto scaleY = qreal(scaledSize.height()) / m_image.height();
+
+	// map changed rectangles to the thumbnail pixels they contribute to so that overlapping
+	// or adjacent rectangles are rescaled only once
+	QRegion targetRegion;
+	for (const auto& rect : dirtyRegion)
+	{
+		targetRegion += QRectF(rect.x() * scaleX, rect.y() * scaleY,
+							   rect.width() * scaleX, rect.height() * scaleY).toAlignedRect();
+	}
+
+	for (const auto& targetRect : targetRegion & m_scaledFramebuffer.rect())
+	{
+		boxScaleImage(m_image, m_scaledFramebuffer, targetRect);
+	}
+}
+
+
+
 int VncConnection::fullFramebufferUpdateTimeout() const
 {
 	return m_framebufferState == FramebufferState::Valid ?
@@ -841,29 +1108,84 @@ void VncConnection::updateEncodingSettingsFromQuality()
 
 
 
+void VncConnection::sendInputEvents()
+{
+	VncInputEvent event;
+
+	while (m_inputEventQueue.pop(event))
+	{
+		if (isControlFlagSet(ControlFlag::TerminateThread))
+		{
+			continue;
+		}
+
+		switch (event.type)
+		{
+		case VncInputEvent::Type::Pointer:
+			// never drop presses or releases since they have to be delivered at their own position
+			while (event.buttonMask == m_lastPointerButtonMask)
+			{
+				const auto next = m_inputEventQueue.peek();
+				if (next == nullptr || event.canBeMergedWith(*next) == false)
+				{
+					break;
+				}
+				m_inputEventQueue.pop(event);
+			}
+			SendPointerEvent(m_client, event.x, event.y, event.buttonMask);
+			m_lastPointerButtonMask = event.buttonMask;
+			break;
+		case VncInputEvent::Type::Key:
+			SendKeyEvent(m_client, event.key, event.pressed ? TRUE : FALSE);
+			break;
+		}
+	}
+}
+
+
+
 void VncConnection::sendEvents()
 {
+	sendInputEvents();
+
+	// take all pending events at once so the queue mutex is not held while sending
 	m_eventQueueMutex.lock();
+	const auto events = std::exchange(m_eventQueue, {});
+	m_eventQueueMutex.unlock();
 
-	while( m_eventQueue.isEmpty() == false )
-	{
-		auto event = m_eventQueue.dequeue();
+	// back-to-back events which support batching (e.g. feature messages) are written at once
+	QByteArray batchBuffer;
 
-		// unlock the queue mutex during the runtime of ClientEvent::fire()
-		m_eventQueueMutex.unlock();
+	const auto flushBatchBuffer = [&]() {
+		if (batchBuffer.isEmpty() == false)
+		{
+			WriteToRFBServer(m_client, batchBuffer.constData(), static_cast<unsigned int>(batchBuffer.size()));
+			batchBuffer.clear();
+		}
+	};
 
-		if( isControlFlagSet( ControlFlag::TerminateThread ) == false )
+	for (auto* event : events)
+	{
+		if (isControlFlagSet(ControlFlag::TerminateThread) == false)
 		{
-			event->fire( m_client );
+			if (event->batch(m_client, batchBuffer) == false)
+			{
+				flushBatchBuffer();
+				event->fire(m_client);
+			}
+			else if (batchBuffer.size() >= MaximumEventBatchSize)
+			{
+				flushBatchBuffer();
+			}
 		}
 
 		delete event;
-
-		// and lock it again
-		m_eventQueueMutex.lock();
 	}
 
-	m_eventQueueMutex.unlock();
+	if (isControlFlagSet(ControlFlag::TerminateThread) == false)
+	{
+		flushBatchBuffer();
+	}
 }
 
 
@@ -875,10 +1197,23 @@ void VncConnection::deleteLaterInMainThread()
 
 
 
+void VncConnection::wakeUp()
+{
+	m_updateIntervalSleeper.wakeAll();
+
+	if (m_managedByEngine)
+	{
+		VncConnectionEngine::instance()->wake(this);
+	}
+}
+
+
+
 void VncConnection::enqueueEvent(VncEvent* event)
 {
 	if( state() != State::Connected )
 	{
+		delete event;
 		return;
 	}
 
@@ -886,7 +1221,25 @@ void VncConnection::enqueueEvent(VncEvent* event)
 	m_eventQueue.enqueue( event );
 	m_eventQueueMutex.unlock();
 
-	m_updateIntervalSleeper.wakeAll();
+	wakeUp();
+}
+
+
+
+void VncConnection::enqueueInputEvent(const VncInputEvent& event)
+{
+	if (state() != State::Connected)
+	{
+		return;
+	}
+
+	if (m_inputEventQueue.push(event) == false)
+	{
+		vWarning() << "input event queue full - discarding event";
+		return;
+	}
+
+	wakeUp();
 }
 
 
@@ -894,21 +1247,32 @@ void VncConnection::enqueueEvent(VncEvent* event)
 bool VncConnection::isEventQueueEmpty()
 {
 	QMutexLocker lock( &m_eventQueueMutex );
-	return m_eventQueue.isEmpty();
+	return m_eventQueue.isEmpty() && m_inputEventQueue.isEmpty();
 }
 
 
 
 void VncConnection::mouseEvent( int x, int y, int buttonMask )
 {
-	enqueueEvent(new VncPointerEvent(x, y, buttonMask));
+	VncInputEvent event;
+	event.type = VncInputEvent::Type::Pointer;
+	event.x = x;
+	event.y = y;
+	event.buttonMask = buttonMask;
+
+	enqueueInputEvent(event);
 }
 
 
 
 void VncConnection::keyEvent( unsigned int key, bool pressed )
 {
-	enqueueEvent(new VncKeyEvent(key, pressed));
+	VncInputEvent event;
+	event.type = VncInputEvent::Type::Key;
+	event.key = key;
+	event.pressed = pressed;
+
+	enqueueInputEvent(event);
 }
 
 
@@ -32,6 +32,7 @@
 #include <QMutex>
 #include <QQueue>
 #include <QReadWriteLock>
+#include <QRegion>
 #include <QThread>
 #include <QTimer>
 #include <QWaitCondition>
@@ -39,6 +40,7 @@
 #include "SocketDevice.h"
 #include "VeyonCore.h"
 #include "VncConnectionConfiguration.h"
+#include "VncInputEventQueue.h"
 
 using rfbClient = struct _rfbClient;
 
@@ -61,6 +63,12 @@ public:
 		Incremental
 	};
 
+	struct Statistics
+	{
+		qint64 decodeTime{0}; // nanoseconds spent handling server messages
+		int framebufferUpdates{0};
+	};
+
 	enum class State
 	{
 		None,
@@ -96,7 +104,13 @@ public:
 
 	bool isConnected() const
 	{
-		return state() == State::Connected && isRunning();
+		return state() == State::Connected && isActive();
+	}
+
+	/** \brief Returns whether the connection is driven either by its own thread or by the shared connection engine */
+	bool isActive() const
+	{
+		return isRunning() || m_managedByEngine;
 	}
 
 	const QString& host() const
@@ -125,11 +139,22 @@ public:
 
 	void setFramebufferUpdateInterval( int interval );
 
+	void requestFullFramebufferUpdate();
+
 	void setSkipFramebufferUpdates(bool on)
 	{
 		setControlFlag(ControlFlag::SkipFramebufferUpdates, on);
 	}
 
+	/** \brief Keeps the scaled framebuffer up to date on the connection thread by rescaling the regions
+	 *  changed by each framebuffer update instead of rescaling the whole framebuffer on demand */
+	void setThumbnailMode(bool on);
+
+	bool isThumbnailMode()
+	{
+		return isControlFlagSet(ControlFlag::ThumbnailMode);
+	}
+
 	void setSkipHostPing( bool on )
 	{
 		setControlFlag( ControlFlag::SkipHostPing, on );
@@ -142,6 +167,9 @@ public:
 
 	void rescaleFramebuffer();
 
+	/** \brief Returns statistics collected since the last call and resets them */
+	Statistics takeStatistics();
+
 	static constexpr int VncConnectionTag = 0x590123;
 
 	static void* clientData( rfbClient* client, int tag );
@@ -174,6 +202,8 @@ private:
 	static constexpr int RfbSamplesPerPixel = 3;
 	static constexpr int RfbBytesPerPixel = sizeof(RfbPixel);
 
+	static constexpr int MaximumEventBatchSize = 1024*1024;
+
 	enum class ControlFlag {
 		ScaledFramebufferNeedsUpdate = 0x01,
 		ServerReachable = 0x02,
@@ -183,15 +213,25 @@ private:
 		SkipHostPing = 0x20,
 		RequiresManualUpdateRateControl = 0x40,
 		TriggerFramebufferUpdate = 0x80,
-		SkipFramebufferUpdates = 0x100
+		SkipFramebufferUpdates = 0x100,
+		ThumbnailMode = 0x200,
+		TriggerFullFramebufferUpdate = 0x400
 	};
 
 	~VncConnection() override;
 
 	void establishConnection();
+	void prepareConnection();
+	bool connectToServer();
 	void handleConnection();
+	bool serviceConnection(int waitTimeout);
 	void closeConnection();
 
+	bool isConnectionAlive();
+	bool hasPendingWork();
+	int manualUpdateRateControlDelay(qint64 elapsed);
+	int connectionRetryInterval() const;
+
 	void setState( State state );
 
 	void setControlFlag( ControlFlag flag, bool on );
@@ -200,16 +240,21 @@ private:
 	bool initFrameBuffer();
 	void requestFrameufferUpdate(FramebufferUpdateType updateType);
 	void finishFrameBufferUpdate();
+	void updateScaledFramebuffer();
 
 	int fullFramebufferUpdateTimeout() const;
 	int incrementalFramebufferUpdateTimeout() const;
 
 	void updateEncodingSettingsFromQuality();
 
+	void enqueueInputEvent(const VncInputEvent& event);
+	void sendInputEvents();
 	void sendEvents();
 
 	void deleteLaterInMainThread();
 
+	void wakeUp();
+
 	// hooks for LibVNCClient
 	static int8_t hookInitFrameBuffer( rfbClient* client );
 	static void hookUpdateFB( rfbClient* client, int x, int y, int w, int h );
@@ -238,6 +283,10 @@ private:
 	std::atomic<State> m_state;
 	std::atomic<FramebufferState> m_framebufferState;
 	QAtomicInt m_controlFlags;
+	std::atomic<bool> m_managedByEngine{false};
+	QMutex m_engineTaskMutex;
+	QWaitCondition m_engineTaskFinished;
+	bool m_engineTaskActive{false};
 
 	// connection parameters and data
 	rfbClient* m_client;
@@ -255,13 +304,24 @@ private:
 	QElapsedTimer m_fullFramebufferUpdateTimer{};
 	QElapsedTimer m_incrementalFramebufferUpdateTimer{};
 
+	// statistics
+	std::atomic<qint64> m_decodeTime{0};
+	std::atomic<int> m_framebufferUpdateCount{0};
+
 	// queue for RFB and custom events
 	QQueue<VncEvent *> m_eventQueue;
+	VncInputEventQueue m_inputEventQueue{};
+	int m_lastPointerButtonMask{0};
 
 	// framebuffer data and thread synchronization objects
 	QImage m_image{};
 	QImage m_scaledFramebuffer{};
 	QSize m_scaledSize{};
 	QReadWriteLock m_imgLock{};
+	QMutex m_scaledFramebufferMutex{};
+	QRegion m_dirtyRegion{};
+
+	friend class VncConnectionEngine;
+	friend class VncConnectionEngineContext;
 
 } ;
@@ -53,4 +53,10 @@ public:
 	static constexpr int DefaultSocketKeepaliveInterval = 500;
 	static constexpr int DefaultSocketKeepaliveCount = 5;
 
+	// shared connection engine (0 = derive from number of CPU cores)
+	static constexpr int DefaultEngineIoThreadCount = 0;
+	static constexpr int DefaultEngineDecoderThreadCount = 0;
+	static constexpr int DefaultEngineConnectThreadCount = 32;
+	static constexpr int DefaultEngineTickInterval = 10;
+
 } ;
@@ -0,0 +1,463 @@
+/*
+ * VncConnectionEngine.cpp - implementation of VncConnectionEngine class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <rfb/rfbclient.h>
+
+#include <QElapsedTimer>
+#include <QSocketNotifier>
+#include <QThread>
+#include <QTimer>
+
+#include "VeyonConfiguration.h"
+#include "VncConnection.h"
+#include "VncConnectionEngine.h"
+
+
+static VncConnectionEngine* __vncConnectionEngine = nullptr;
+
+
+// schedules connection attempts and servicing of all connections assigned to one I/O thread
+class VncConnectionEngineContext : public QObject
+{
+public:
+	explicit VncConnectionEngineContext(VncConnectionEngine* engine) :
+		QObject(),
+		m_engine(engine),
+		m_tickTimer(this)
+	{
+		connect(&m_tickTimer, &QTimer::timeout, this, &VncConnectionEngineContext::tick);
+	}
+
+	~VncConnectionEngineContext() override
+	{
+		for (auto it = m_entries.begin(), end = m_entries.end(); it != end; ++it)
+		{
+			delete it->notifier;
+		}
+	}
+
+	void start()
+	{
+		m_clock.start();
+		m_tickTimer.start(VncConnectionConfiguration::DefaultEngineTickInterval);
+	}
+
+	void addConnection(VncConnection* connection)
+	{
+		processConnection(connection, *m_entries.insert(connection, {}));
+	}
+
+	void removeConnection(VncConnection* connection)
+	{
+		const auto it = m_entries.find(connection);
+		if (it != m_entries.end())
+		{
+			delete it->notifier;
+			m_entries.erase(it);
+		}
+	}
+
+	void wakeConnection(VncConnection* connection)
+	{
+		const auto it = m_entries.find(connection);
+		if (it != m_entries.end())
+		{
+			it->wakeUpPending = true;
+			it->notBefore = 0;
+			processConnection(connection, *it);
+		}
+	}
+
+private:
+	struct Entry
+	{
+		QSocketNotifier* notifier{nullptr};
+		QElapsedTimer connectionTimer{};
+		qint64 notBefore{0};
+		bool busy{false};
+		bool prepared{false};
+		bool readable{false};
+		bool wakeUpPending{false};
+	};
+
+	void tick()
+	{
+		const auto connections = m_entries.keys();
+		for (auto* connection : connections)
+		{
+			const auto it = m_entries.find(connection);
+			if (it != m_entries.end())
+			{
+				processConnection(connection, *it);
+			}
+		}
+	}
+
+	void processConnection(VncConnection* connection, Entry& entry)
+	{
+		if (entry.busy || m_clock.elapsed() < entry.notBefore)
+		{
+			return;
+		}
+
+		if (entry.notifier == nullptr)
+		{
+			if (connection->isControlFlagSet(VncConnection::ControlFlag::TerminateThread))
+			{
+				connection->closeConnection();
+				releaseConnection(connection);
+			}
+			else
+			{
+				scheduleConnect(connection, entry);
+			}
+		}
+		else if (entry.readable || entry.wakeUpPending || connection->hasPendingWork())
+		{
+			scheduleService(connection, entry);
+		}
+	}
+
+	void handleReadable(VncConnection* connection)
+	{
+		const auto it = m_entries.find(connection);
+		if (it != m_entries.end() && it->notifier)
+		{
+			it->notifier->setEnabled(false);
+			it->readable = true;
+			processConnection(connection, *it);
+		}
+	}
+
+	static void setTaskActive(VncConnection* connection, bool active)
+	{
+		QMutexLocker locker(&connection->m_engineTaskMutex);
+		connection->m_engineTaskActive = active;
+		if (active == false)
+		{
+			connection->m_engineTaskFinished.wakeAll();
+		}
+	}
+
+	void scheduleConnect(VncConnection* connection, Entry& entry)
+	{
+		const auto prepare = entry.prepared == false;
+		if (prepare)
+		{
+			entry.prepared = true;
+			entry.connectionTimer.start();
+		}
+
+		entry.busy = true;
+		setTaskActive(connection, true);
+
+		m_engine->m_connectPool.start([=]() {
+			if (prepare)
+			{
+				connection->prepareConnection();
+			}
+			const auto connected = connection->connectToServer();
+			QMetaObject::invokeMethod(this, [=]() { finishConnect(connection, connected); }, Qt::QueuedConnection);
+			setTaskActive(connection, false);
+		});
+	}
+
+	void finishConnect(VncConnection* connection, bool connected)
+	{
+		const auto it = m_entries.find(connection);
+		if (it == m_entries.end())
+		{
+			return;
+		}
+
+		auto& entry = *it;
+		entry.busy = false;
+
+		if (connection->isControlFlagSet(VncConnection::ControlFlag::TerminateThread))
+		{
+			connection->closeConnection();
+			releaseConnection(connection);
+		}
+		else if (connected)
+		{
+			entry.notifier = new QSocketNotifier(static_cast<qintptr>(connection->m_client->sock),
+												 QSocketNotifier::Read, this);
+			connect(entry.notifier, &QSocketNotifier::activated, this, [=]() { handleReadable(connection); });
+			scheduleService(connection, entry);
+		}
+		else
+		{
+			entry.notBefore = m_clock.elapsed() + connection->connectionRetryInterval();
+		}
+	}
+
+	void scheduleService(VncConnection* connection, Entry& entry)
+	{
+		entry.busy = true;
+		entry.readable = false;
+		entry.wakeUpPending = false;
+		entry.notifier->setEnabled(false);
+		setTaskActive(connection, true);
+
+		m_engine->m_decoderPool.start([=]() {
+			QElapsedTimer serviceTimer;
+			serviceTimer.start();
+
+			auto alive = connection->serviceConnection(0);
+			if (alive)
+			{
+				connection->sendEvents();
+				alive = connection->isConnectionAlive();
+			}
+
+			// compat with Veyon Server < 4.7
+			const auto delay = alive ? connection->manualUpdateRateControlDelay(serviceTimer.elapsed()) : 0;
+
+			QMetaObject::invokeMethod(this, [=]() { finishService(connection, alive, delay); }, Qt::QueuedConnection);
+			setTaskActive(connection, false);
+		});
+	}
+
+	void finishService(VncConnection* connection, bool alive, int delay)
+	{
+		const auto it = m_entries.find(connection);
+		if (it == m_entries.end())
+		{
+			return;
+		}
+
+		auto& entry = *it;
+		entry.busy = false;
+
+		if (alive == false)
+		{
+			closeConnection(connection, entry);
+			return;
+		}
+
+		entry.notifier->setEnabled(true);
+
+		if (entry.wakeUpPending)
+		{
+			processConnection(connection, entry);
+		}
+		else
+		{
+			entry.notBefore = m_clock.elapsed() + delay;
+		}
+	}
+
+	void closeConnection(VncConnection* connection, Entry& entry)
+	{
+		delete entry.notifier;
+		entry.notifier = nullptr;
+
+		connection->closeConnection();
+
+		if (connection->isControlFlagSet(VncConnection::ControlFlag::TerminateThread))
+		{
+			releaseConnection(connection);
+			return;
+		}
+
+		// reconnect no earlier than VncConnection::run() would do
+		entry.prepared = false;
+		entry.notBefore = m_clock.elapsed() +
+						  std::max<qint64>(0, connection->connectionRetryInterval() - entry.connectionTimer.elapsed());
+	}
+
+	void releaseConnection(VncConnection* connection)
+	{
+		removeConnection(connection);
+
+		m_engine->unregisterConnection(connection);
+		connection->m_managedByEngine = false;
+
+		if (connection->isControlFlagSet(VncConnection::ControlFlag::DeleteAfterFinished))
+		{
+			connection->deleteLaterInMainThread();
+		}
+	}
+
+	VncConnectionEngine* m_engine;
+	QTimer m_tickTimer;
+	QElapsedTimer m_clock{};
+	QHash<VncConnection *, Entry> m_entries{};
+
+};
+
+
+
+VncConnectionEngine::VncConnectionEngine(QObject* parent) :
+	QObject(parent)
+{
+	const auto idealThreadCount = std::max(1, QThread::idealThreadCount());
+
+	auto ioThreadCount = VeyonCore::config().vncConnectionEngineIoThreadCount();
+	if (ioThreadCount <= 0)
+	{
+		ioThreadCount = qBound(1, idealThreadCount / 4, 4);
+	}
+
+	auto decoderThreadCount = VeyonCore::config().vncConnectionEngineDecoderThreadCount();
+	if (decoderThreadCount <= 0)
+	{
+		decoderThreadCount = idealThreadCount;
+	}
+
+	m_decoderPool.setMaxThreadCount(decoderThreadCount);
+	m_connectPool.setMaxThreadCount(std::max(1, VeyonCore::config().vncConnectionEngineConnectThreadCount()));
+
+	for (int i = 0; i < ioThreadCount; ++i)
+	{
+		auto thread = new QThread(this);
+		thread->setObjectName(QStringLiteral("VncConnectionEngine-%1").arg(i));
+
+		auto context = new VncConnectionEngineContext(this);
+		context->moveToThread(thread);
+
+		connect(thread, &QThread::started, context, &VncConnectionEngineContext::start);
+		connect(thread, &QThread::finished, context, &QObject::deleteLater);
+
+		m_ioThreads.append(thread);
+		m_contexts.append(context);
+
+		thread->start();
+	}
+
+	vDebug() << "I/O threads:" << ioThreadCount << "decoder threads:" << decoderThreadCount;
+}
+
+
+
+VncConnectionEngine::~VncConnectionEngine()
+{
+	m_connectPool.waitForDone();
+	m_decoderPool.waitForDone();
+
+	for (auto* thread : std::as_const(m_ioThreads))
+	{
+		thread->quit();
+		thread->wait();
+	}
+
+	if (__vncConnectionEngine == this)
+	{
+		__vncConnectionEngine = nullptr;
+	}
+}
+
+
+
+bool VncConnectionEngine::isEnabled()
+{
+	return VeyonCore::config().vncConnectionUseSharedEngine();
+}
+
+
+
+VncConnectionEngine* VncConnectionEngine::instance()
+{
+	static QMutex instanceMutex;
+	QMutexLocker locker(&instanceMutex);
+
+	if (__vncConnectionEngine == nullptr)
+	{
+		__vncConnectionEngine = new VncConnectionEngine(VeyonCore::instance());
+	}
+
+	return __vncConnectionEngine;
+}
+
+
+
+void VncConnectionEngine::attach(VncConnection* connection)
+{
+	connection->m_managedByEngine = true;
+
+	m_connectionsMutex.lock();
+	auto context = m_contexts.at(m_nextContext);
+	m_nextContext = (m_nextContext + 1) % m_contexts.count();
+	m_connections[connection] = context;
+	m_connectionsMutex.unlock();
+
+	QMetaObject::invokeMethod(context, [=]() { context->addConnection(connection); }, Qt::QueuedConnection);
+}
+
+
+
+void VncConnectionEngine::detach(VncConnection* connection)
+{
+	m_connectionsMutex.lock();
+	auto context = m_connections.take(connection);
+	m_connectionsMutex.unlock();
+
+	if (context)
+	{
+		if (context->thread() == QThread::currentThread())
+		{
+			context->removeConnection(connection);
+		}
+		else
+		{
+			QMetaObject::invokeMethod(context, [=]() { context->removeConnection(connection); },
+									  Qt::BlockingQueuedConnection);
+		}
+	}
+
+	// no further tasks get scheduled now, however wait for the current one to finish; regular
+	// teardown via stopAndDeleteLater() is deferred until the engine released the connection,
+	// so this only blocks if a connection is destroyed directly while being serviced
+	connection->m_engineTaskMutex.lock();
+	while (connection->m_engineTaskActive)
+	{
+		connection->m_engineTaskFinished.wait(&connection->m_engineTaskMutex);
+	}
+	connection->m_engineTaskMutex.unlock();
+
+	connection->closeConnection();
+	connection->m_managedByEngine = false;
+}
+
+
+
+void VncConnectionEngine::wake(VncConnection* connection)
+{
+	m_connectionsMutex.lock();
+	auto context = m_connections.value(connection);
+	m_connectionsMutex.unlock();
+
+	if (context)
+	{
+		QMetaObject::invokeMethod(context, [=]() { context->wakeConnection(connection); }, Qt::QueuedConnection);
+	}
+}
+
+
+
+void VncConnectionEngine::unregisterConnection(VncConnection* connection)
+{
+	QMutexLocker locker(&m_connectionsMutex);
+	m_connections.remove(connection);
+}
@@ -0,0 +1,75 @@
+/*
+ * VncConnectionEngine.h - declaration of VncConnectionEngine class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QThreadPool>
+
+#include "VeyonCore.h"
+
+class QThread;
+class VncConnection;
+class VncConnectionEngineContext;
+
+/**
+ * \brief Drives many VncConnection instances with a small fixed set of threads
+ *
+ * Instead of running one blocking thread per connection, sockets of established
+ * connections are watched by a few I/O threads. Whenever a connection has data
+ * or pending work, it is serviced by a bounded decoder thread pool. Blocking
+ * connection attempts run on a separate bounded pool so that unreachable hosts
+ * do not stall decoding.
+ */
+class VEYON_CORE_EXPORT VncConnectionEngine : public QObject
+{
+	Q_OBJECT
+public:
+	explicit VncConnectionEngine(QObject* parent = nullptr);
+	~VncConnectionEngine() override;
+
+	static bool isEnabled();
+	static VncConnectionEngine* instance();
+
+	void attach(VncConnection* connection);
+	void detach(VncConnection* connection);
+	void wake(VncConnection* connection);
+
+private:
+	void unregisterConnection(VncConnection* connection);
+
+	QThreadPool m_connectPool{};
+	QThreadPool m_decoderPool{};
+
+	QList<QThread *> m_ioThreads{};
+	QList<VncConnectionEngineContext *> m_contexts{};
+	int m_nextContext{0};
+
+	QMutex m_connectionsMutex{};
+	QHash<VncConnection *, VncConnectionEngineContext *> m_connections{};
+
+	friend class VncConnectionEngineContext;
+
+};
@@ -36,33 +36,14 @@ public:
 	virtual ~VncEvent() = default;
 	virtual void fire( rfbClient* client ) = 0;
 
-} ;
-
-
-class VncKeyEvent : public VncEvent
-{
-public:
-	VncKeyEvent( unsigned int key, bool pressed );
+	// appends the wire data of the event to buffer if it can be sent together with other events
+	virtual bool batch( rfbClient* client, QByteArray& buffer )
+	{
+		Q_UNUSED(client)
+		Q_UNUSED(buffer)
+		return false;
+	}
 
-	void fire( rfbClient* client ) override;
-
-private:
-	unsigned int m_key;
-	bool m_pressed;
-} ;
-
-
-class VncPointerEvent : public VncEvent
-{
-public:
-	VncPointerEvent( int x, int y, int buttonMask );
-
-	void fire( rfbClient* client ) override;
-
-private:
-	int m_x;
-	int m_y;
-	int m_buttonMask;
 } ;
 
 
@@ -29,8 +29,9 @@
 #include "VncFeatureMessageEvent.h"
 
 
-VncFeatureMessageEvent::VncFeatureMessageEvent( const FeatureMessage& featureMessage ) :
-	m_featureMessage( featureMessage )
+VncFeatureMessageEvent::VncFeatureMessageEvent( const FeatureMessage& featureMessage, const QByteArray& rfbMessage ) :
+	m_featureMessage( featureMessage ),
+	m_rfbMessage( rfbMessage )
 {
 }
 
@@ -43,5 +44,24 @@ void VncFeatureMessageEvent::fire( rfbClient* client )
 
 	SocketDevice socketDevice( VncConnection::libvncClientDispatcher, client );
 
-	m_featureMessage.sendAsRfbMessage(&socketDevice);
+	if( m_rfbMessage.isEmpty() )
+	{
+		m_featureMessage.sendAsRfbMessage(&socketDevice);
+	}
+	else
+	{
+		socketDevice.write( m_rfbMessage.constData(), m_rfbMessage.size() );
+	}
+}
+
+
+
+bool VncFeatureMessageEvent::batch( rfbClient* client, QByteArray& buffer )
+{
+	vDebug() << qUtf8Printable(QStringLiteral("%1:%2").arg(QString::fromUtf8(client->serverHost)).arg(client->serverPort))
+			 << m_featureMessage;
+
+	buffer.append(m_rfbMessage.isEmpty() ? m_featureMessage.toRfbMessage() : m_rfbMessage);
+
+	return true;
 }
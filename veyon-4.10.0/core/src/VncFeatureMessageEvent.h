@@ -32,11 +32,15 @@
 class VncFeatureMessageEvent : public VncEvent
 {
 public:
-	explicit VncFeatureMessageEvent( const FeatureMessage& featureMessage );
+	// rfbMessage optionally holds the already serialized message (e.g. when sending
+	// the same message to many computers) which is written as is then
+	explicit VncFeatureMessageEvent( const FeatureMessage& featureMessage, const QByteArray& rfbMessage = {} );
 
 	void fire( rfbClient* client ) override;
+	bool batch( rfbClient* client, QByteArray& buffer ) override;
 
 private:
 	FeatureMessage m_featureMessage;
+	const QByteArray m_rfbMessage;
 
 } ;
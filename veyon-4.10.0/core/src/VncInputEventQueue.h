@@ -0,0 +1,112 @@
+/*
+ * VncInputEventQueue.h - lock-free queue for keyboard and pointer events
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+struct VncInputEvent
+{
+	enum class Type {
+		Key,
+		Pointer
+	};
+
+	Type type{Type::Pointer};
+	int x{0};
+	int y{0};
+	int buttonMask{0};
+	unsigned int key{0};
+	bool pressed{false};
+
+	// consecutive pointer events with the same button state only need to deliver the last position,
+	// however the caller has to ensure that this event itself does not change the button state
+	bool canBeMergedWith(const VncInputEvent& other) const
+	{
+		return type == Type::Pointer && other.type == Type::Pointer && buttonMask == other.buttonMask;
+	}
+};
+
+
+// single-producer/single-consumer ring buffer, i.e. push() must only be called from one thread
+// (the GUI thread) and pop()/peek() from another one (the connection thread)
+class VncInputEventQueue
+{
+public:
+	static constexpr size_t Capacity = 1024;
+
+	bool push(const VncInputEvent& event)
+	{
+		const auto tail = m_tail.load(std::memory_order_relaxed);
+		if (tail - m_head.load(std::memory_order_acquire) >= Capacity)
+		{
+			return false;
+		}
+
+		m_events[tail % Capacity] = event;
+		m_tail.store(tail + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	bool pop(VncInputEvent& event)
+	{
+		const auto head = m_head.load(std::memory_order_relaxed);
+		if (head == m_tail.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		event = m_events[head % Capacity];
+		m_head.store(head + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	const VncInputEvent* peek() const
+	{
+		const auto head = m_head.load(std::memory_order_relaxed);
+		if (head == m_tail.load(std::memory_order_acquire))
+		{
+			return nullptr;
+		}
+
+		return &m_events[head % Capacity];
+	}
+
+	bool isEmpty() const
+	{
+		return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+	}
+
+private:
+	static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+	std::array<VncInputEvent, Capacity> m_events{};
+	alignas(64) std::atomic<size_t> m_head{0};
+	alignas(64) std::atomic<size_t> m_tail{0};
+
+};
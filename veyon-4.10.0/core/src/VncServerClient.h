@@ -38,6 +38,7 @@ public:
 		Challenge,
 		Password,
 		Token,
+		SessionTicket,
 		Successful,
 		Failed,
 	} ;
@@ -119,6 +120,16 @@ public:
 		return m_accessControlTimer;
 	}
 
+	bool isSessionTicketRequested() const
+	{
+		return m_sessionTicketRequested;
+	}
+
+	void setSessionTicketRequested( bool requested )
+	{
+		m_sessionTicketRequested = requested;
+	}
+
 	const QString& username() const
 	{
 		return m_username;
@@ -159,6 +170,26 @@ public:
 		m_privateKey = privateKey;
 	}
 
+	const CryptoCore::PublicKey& publicKey() const
+	{
+		return m_publicKey;
+	}
+
+	void setPublicKey( const CryptoCore::PublicKey& publicKey )
+	{
+		m_publicKey = publicKey;
+	}
+
+	const QByteArray& sessionTicketKey() const
+	{
+		return m_sessionTicketKey;
+	}
+
+	void setSessionTicketKey( const QByteArray& key )
+	{
+		m_sessionTicketKey = key;
+	}
+
 public Q_SLOTS:
 	void finishAccessControl()
 	{
@@ -172,6 +203,7 @@ private:
 	VncServerProtocol::State m_protocolState;
 	AuthState m_authState;
 	RfbVeyonAuth::Type m_authType;
+	bool m_sessionTicketRequested{false};
 	AccessControlState m_accessControlState;
 	QString m_accessControlDetails;
 	QElapsedTimer m_accessControlTimer;
@@ -179,6 +211,8 @@ private:
 	QString m_hostAddress;
 	QByteArray m_challenge;
 	CryptoCore::PrivateKey m_privateKey;
+	CryptoCore::PublicKey m_publicKey;
+	QByteArray m_sessionTicketKey;
 
 } ;
 
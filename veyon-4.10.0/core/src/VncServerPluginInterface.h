@@ -56,6 +56,14 @@ public:
 
 	virtual Password configuredPassword() = 0;
 
+	/*!
+	 * \brief Returns whether the VNC server is able to scale the framebuffer per client upon rfbSetScale messages
+	 */
+	virtual bool supportsFramebufferScaling() const
+	{
+		return false;
+	}
+
 } ;
 
 using VncServerPluginInterfaceList = QList<VncServerPluginInterface *>;
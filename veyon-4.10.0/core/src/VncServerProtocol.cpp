@@ -226,8 +226,12 @@ bool VncServerProtocol::receiveAuthenticationTypeResponse()
 
 		const auto username = message.read().toString();
 
+		// optional field which is not sent by older clients
+		const auto sessionTicketRequested = message.read().toBool();
+
 		m_client->setAuthType( chosenAuthType );
 		m_client->setUsername( username );
+		m_client->setSessionTicketRequested( sessionTicketRequested );
 
 		setState( State::Authenticating );
 
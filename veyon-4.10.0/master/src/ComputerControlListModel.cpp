@@ -28,6 +28,7 @@
 #include "ComputerManager.h"
 #include "FeatureManager.h"
 #include "PlatformSessionFunctions.h"
+#include "VeyonConfiguration.h"
 #include "VeyonMaster.h"
 #include "UserConfig.h"
 
@@ -43,7 +44,8 @@ ComputerControlListModel::ComputerControlListModel( VeyonMaster* masterCore, QOb
 	m_iconHostOnline(QStringLiteral(":/master/host-online.png")),
 	m_iconHostNameResolutionFailed(QStringLiteral(":/master/host-dns-error.png")),
 	m_iconHostAccessDenied(QStringLiteral(":/master/host-access-denied.png")),
-	m_iconHostServiceError(QStringLiteral(":/master/host-service-error.png"))
+	m_iconHostServiceError(QStringLiteral(":/master/host-service-error.png")),
+	m_suspendHiddenComputers(VeyonCore::config().computerMonitoringSuspendHiddenComputers())
 {
 #if defined(QT_TESTLIB_LIB)
 	new QAbstractItemModelTester( this, QAbstractItemModelTester::FailureReportingMode::Warning, this );
@@ -125,6 +127,39 @@ QVariant ComputerControlListModel::data( const QModelIndex& index, int role ) co
 
 
 
+void ComputerControlListModel::setVisibleComputerControlInterfaces( const QObject* view,
+																   const ComputerControlInterfaceList& computerControlInterfaces )
+{
+	if( m_suspendHiddenComputers == false )
+	{
+		return;
+	}
+
+	QSet<ComputerControlInterface *> visibleComputerControlInterfaces;
+	visibleComputerControlInterfaces.reserve( computerControlInterfaces.size() );
+
+	for( const auto& computerControlInterface : computerControlInterfaces )
+	{
+		visibleComputerControlInterfaces.insert( computerControlInterface.data() );
+	}
+
+	m_visibleComputerControlInterfaces[view] = visibleComputerControlInterfaces;
+
+	updateVisibility();
+}
+
+
+
+void ComputerControlListModel::removeView( const QObject* view )
+{
+	if( m_visibleComputerControlInterfaces.remove( view ) )
+	{
+		updateVisibility();
+	}
+}
+
+
+
 void ComputerControlListModel::updateComputerScreenSize()
 {
 	auto ratio = 16.0 / 9.0;
@@ -248,6 +283,37 @@ void ComputerControlListModel::update()
 
 
 
+void ComputerControlListModel::updateVisibility()
+{
+	QSet<ComputerControlInterface *> visibleComputerControlInterfaces;
+	for( auto it = m_visibleComputerControlInterfaces.constBegin(), end = m_visibleComputerControlInterfaces.constEnd();
+		 it != end; ++it )
+	{
+		visibleComputerControlInterfaces.unite( *it );
+	}
+
+	// suspend framebuffer updates for computers not shown in any view and resume them as soon as
+	// they become visible again while leaving other update modes (e.g. Live mode in spotlight) untouched
+	for( const auto& controlInterface : std::as_const(m_computerControlInterfaces) )
+	{
+		const auto updateMode = controlInterface->updateMode();
+
+		if( visibleComputerControlInterfaces.contains( controlInterface.data() ) )
+		{
+			if( updateMode == ComputerControlInterface::UpdateMode::FeatureControlOnly )
+			{
+				controlInterface->setUpdateMode( ComputerControlInterface::UpdateMode::Monitoring );
+			}
+		}
+		else if( updateMode == ComputerControlInterface::UpdateMode::Monitoring )
+		{
+			controlInterface->setUpdateMode( ComputerControlInterface::UpdateMode::FeatureControlOnly );
+		}
+	}
+}
+
+
+
 QModelIndex ComputerControlListModel::interfaceIndex( ComputerControlInterface* controlInterface ) const
 {
 	return ComputerListModel::index( m_computerControlInterfaces.indexOf( controlInterface->weakPointer() ), 0 );
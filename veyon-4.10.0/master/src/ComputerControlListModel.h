@@ -26,6 +26,7 @@
 
 #include <QAbstractListModel>
 #include <QImage>
+#include <QSet>
 
 #include "ComputerListModel.h"
 #include "ComputerControlInterface.h"
@@ -58,6 +59,15 @@ public:
 
 	void reload();
 
+	bool suspendHiddenComputers() const
+	{
+		return m_suspendHiddenComputers;
+	}
+
+	void setVisibleComputerControlInterfaces( const QObject* view,
+											  const ComputerControlInterfaceList& computerControlInterfaces );
+	void removeView( const QObject* view );
+
 Q_SIGNALS:
 	void stateChanged(QModelIndex);
 	void activeFeaturesChanged( QModelIndex );
@@ -76,6 +86,8 @@ private:
 	void updateUser( const QModelIndex& index );
 	void updateSessionInfo(const QModelIndex& index);
 
+	void updateVisibility();
+
 	void startComputerControlInterface( ComputerControlInterface* controlInterface );
 	void stopComputerControlInterface( const ComputerControlInterface::Pointer& controlInterface );
 
@@ -102,4 +114,7 @@ private:
 
 	ComputerControlInterfaceList m_computerControlInterfaces{};
 
+	const bool m_suspendHiddenComputers;
+	QHash<const QObject *, QSet<ComputerControlInterface *>> m_visibleComputerControlInterfaces{};
+
 };
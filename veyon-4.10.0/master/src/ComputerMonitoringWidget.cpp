@@ -33,6 +33,7 @@
 #include "ComputerMonitoringWidget.h"
 #include "VeyonMaster.h"
 #include "FeatureManager.h"
+#include "FramebufferUpdateScheduler.h"
 #include "VeyonConfiguration.h"
 
 
@@ -67,6 +68,33 @@ ComputerMonitoringWidget::ComputerMonitoringWidget( QWidget *parent ) :
 	initializeView( this );
 
 	setModel( dataModel() );
+
+	m_visibleComputersUpdateTimer.setSingleShot( true );
+	m_visibleComputersUpdateTimer.setInterval( VisibleComputersUpdateDelay );
+	connect( &m_visibleComputersUpdateTimer, &QTimer::timeout, this, &ComputerMonitoringWidget::updateVisibleComputers );
+
+	if( master() && master()->framebufferUpdateScheduler() )
+	{
+		// prioritize framebuffer updates of the computer under the mouse cursor
+		setMouseTracking( true );
+		connect( this, &QListView::entered, this, [this]( const QModelIndex& index ) {
+			master()->framebufferUpdateScheduler()->setFocusedComputerControlInterface(
+				dataModel()->data( index, ComputerControlListModel::ControlInterfaceRole ).value<ComputerControlInterface::Pointer>() );
+		} );
+		connect( this, &QListView::viewportEntered, this, [this]() {
+			master()->framebufferUpdateScheduler()->setFocusedComputerControlInterface( {} );
+		} );
+	}
+}
+
+
+
+ComputerMonitoringWidget::~ComputerMonitoringWidget()
+{
+	if( master() )
+	{
+		master()->computerControlListModel().removeView( this );
+	}
 }
 
 
@@ -282,6 +310,50 @@ void ComputerMonitoringWidget::addSubFeaturesToMenu( const Feature& parentFeatur
 
 
 
+void ComputerMonitoringWidget::doItemsLayout()
+{
+	FlexibleListView::doItemsLayout();
+
+	scheduleVisibleComputersUpdate();
+}
+
+
+
+void ComputerMonitoringWidget::scheduleVisibleComputersUpdate()
+{
+	if( master() && master()->computerControlListModel().suspendHiddenComputers() )
+	{
+		m_visibleComputersUpdateTimer.start();
+	}
+}
+
+
+
+void ComputerMonitoringWidget::updateVisibleComputers()
+{
+	ComputerControlInterfaceList visibleComputers;
+
+	if( isVisible() && model() )
+	{
+		const auto viewportRect = viewport()->rect();
+		const auto rowCount = model()->rowCount();
+
+		for( int row = 0; row < rowCount; ++row )
+		{
+			const auto index = model()->index( row, 0 );
+			if( isIndexHidden( index ) == false && visualRect( index ).intersects( viewportRect ) )
+			{
+				visibleComputers.append( model()->data( index, ComputerControlListModel::ControlInterfaceRole )
+											 .value<ComputerControlInterface::Pointer>() );
+			}
+		}
+	}
+
+	master()->computerControlListModel().setVisibleComputerControlInterfaces( this, visibleComputers );
+}
+
+
+
 void ComputerMonitoringWidget::runDoubleClickFeature( const QModelIndex& index )
 {
 	const Feature& feature = VeyonCore::featureManager().feature( VeyonCore::config().computerDoubleClickFeature() );
@@ -390,6 +462,8 @@ void ComputerMonitoringWidget::resizeEvent( QResizeEvent* event )
 	{
 		initiateIconSizeAutoAdjust();
 	}
+
+	scheduleVisibleComputersUpdate();
 }
 
 
@@ -402,6 +476,26 @@ void ComputerMonitoringWidget::showEvent( QShowEvent* event )
 	}
 
 	FlexibleListView::showEvent( event );
+
+	scheduleVisibleComputersUpdate();
+}
+
+
+
+void ComputerMonitoringWidget::hideEvent( QHideEvent* event )
+{
+	FlexibleListView::hideEvent( event );
+
+	scheduleVisibleComputersUpdate();
+}
+
+
+
+void ComputerMonitoringWidget::scrollContentsBy( int dx, int dy )
+{
+	FlexibleListView::scrollContentsBy( dx, dy );
+
+	scheduleVisibleComputersUpdate();
 }
 
 
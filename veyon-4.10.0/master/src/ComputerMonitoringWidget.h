@@ -37,7 +37,7 @@ class ComputerMonitoringWidget : public FlexibleListView, public ComputerMonitor
 	Q_OBJECT
 public:
 	explicit ComputerMonitoringWidget( QWidget *parent = nullptr );
-	~ComputerMonitoringWidget() override = default;
+	~ComputerMonitoringWidget() override;
 
 	ComputerControlInterfaceList selectedComputerControlInterfaces() const override;
 
@@ -55,6 +55,8 @@ public:
 
 	void resetIgnoreNumberOfMouseEvents( );
 
+	void doItemsLayout() override;
+
 	QTimer m_mousePressAndHold;
 
 private:
@@ -69,6 +71,9 @@ private:
 	void addFeatureToMenu( const Feature& feature, const QString& label );
 	void addSubFeaturesToMenu( const Feature& parentFeature, const FeatureList& subFeatures, const QString& label );
 
+	void scheduleVisibleComputersUpdate();
+	void updateVisibleComputers();
+
 	void runDoubleClickFeature( const QModelIndex& index );
 	void runMousePressAndHoldFeature( );
 	void stopMousePressAndHoldFeature( );
@@ -79,6 +84,8 @@ private:
 
 	void resizeEvent( QResizeEvent* event ) override;
 	void showEvent( QShowEvent* event ) override;
+	void hideEvent( QHideEvent* event ) override;
+	void scrollContentsBy( int dx, int dy ) override;
 	void wheelEvent( QWheelEvent* event ) override;
 
 	QMenu* m_featureMenu{};
@@ -88,6 +95,9 @@ private:
 	int m_ignoreNumberOfMouseEvents = 0;
 
 	static constexpr auto IgnoredNumberOfMouseEventsWhileHold = 3;
+	static constexpr auto VisibleComputersUpdateDelay = 250;
+
+	QTimer m_visibleComputersUpdateTimer{};
 
 	ComputerZoomWidget* m_computerZoomWidget{nullptr};
 
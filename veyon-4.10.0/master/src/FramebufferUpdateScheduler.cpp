@@ -0,0 +1,141 @@
+/*
+ * FramebufferUpdateScheduler.cpp - implementation of FramebufferUpdateScheduler class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <cmath>
+#include <limits>
+
+#include "FramebufferUpdateScheduler.h"
+#include "VeyonConfiguration.h"
+#include "VeyonMaster.h"
+#include "VncConnection.h"
+
+
+FramebufferUpdateScheduler::FramebufferUpdateScheduler( VeyonMaster& master ) :
+	QObject( &master ),
+	m_master( master ),
+	m_updateRateBudget( VeyonCore::config().computerMonitoringUpdateRateBudget() ),
+	m_decodeTimeBudget( VeyonCore::config().computerMonitoringDecodeTimeBudget() )
+{
+	connect( &m_timer, &QTimer::timeout, this, &FramebufferUpdateScheduler::schedule );
+	m_timer.start( SchedulingInterval );
+}
+
+
+
+bool FramebufferUpdateScheduler::isEnabled()
+{
+	return VeyonCore::config().computerMonitoringUpdateRateBudget() > 0 ||
+		   VeyonCore::config().computerMonitoringDecodeTimeBudget() > 0;
+}
+
+
+
+void FramebufferUpdateScheduler::setFocusedComputerControlInterface( const ComputerControlInterface::Pointer& computerControlInterface )
+{
+	m_focusedComputerControlInterface = computerControlInterface.data();
+}
+
+
+
+void FramebufferUpdateScheduler::schedule()
+{
+	QHash<ComputerControlInterface *, Host> hosts;
+	hosts.reserve( m_hosts.size() );
+
+	ComputerControlInterfaceList scheduledInterfaces;
+	qint64 totalWeight = 0;
+
+	for( const auto& computerControlInterface : m_master.allComputerControlInterfaces() )
+	{
+		const auto vncConnection = computerControlInterface->vncConnection();
+		const auto updateMode = computerControlInterface->updateMode();
+
+		// remote views and zoom widgets (Live mode) are never throttled
+		if( vncConnection == nullptr ||
+			computerControlInterface->state() != ComputerControlInterface::State::Connected ||
+			( updateMode != ComputerControlInterface::UpdateMode::Monitoring &&
+			  updateMode != ComputerControlInterface::UpdateMode::Basic ) )
+		{
+			computerControlInterface->setFramebufferUpdateIntervalLimit( 0 );
+			continue;
+		}
+
+		auto host = m_hosts.value( computerControlInterface.data() );
+
+		const auto statistics = vncConnection->takeStatistics();
+		if( statistics.framebufferUpdates > 0 )
+		{
+			host.decodeTimePerUpdate = std::max<qint64>( 1, statistics.decodeTime / statistics.framebufferUpdates );
+		}
+
+		hosts[computerControlInterface.data()] = host;
+		scheduledInterfaces.append( computerControlInterface );
+
+		totalWeight += weight( computerControlInterface.data() );
+	}
+
+	m_hosts = hosts;
+
+	for( const auto& computerControlInterface : std::as_const( scheduledInterfaces ) )
+	{
+		const auto& host = m_hosts[computerControlInterface.data()];
+		const auto share = qreal( weight( computerControlInterface.data() ) ) / qreal( totalWeight );
+
+		// maximum number of updates per second this computer may consume
+		auto updateRate = std::numeric_limits<qreal>::max();
+		if( m_updateRateBudget > 0 )
+		{
+			updateRate = std::min( updateRate, m_updateRateBudget * share );
+		}
+		if( m_decodeTimeBudget > 0 )
+		{
+			// the measured decoding time only limits how many updates fit into the share so that
+			// throttled computers (with few measured updates) do not lose further share
+			const auto decodeTimeShare = m_decodeTimeBudget * share * 1000 * 1000; // ms -> ns
+			updateRate = std::min( updateRate, decodeTimeShare / host.decodeTimePerUpdate );
+		}
+
+		int interval = MaximumUpdateInterval;
+		if( updateRate * MaximumUpdateInterval > 1000 )
+		{
+			// round up to avoid frequent interval changes being sent to the server
+			interval = int( std::ceil( 1000 / updateRate / UpdateIntervalGranularity ) ) * UpdateIntervalGranularity;
+		}
+
+		computerControlInterface->setFramebufferUpdateIntervalLimit( interval );
+	}
+}
+
+
+
+int FramebufferUpdateScheduler::weight( ComputerControlInterface* computerControlInterface ) const
+{
+	if( computerControlInterface == m_focusedComputerControlInterface )
+	{
+		return FocusedWeight;
+	}
+
+	return computerControlInterface->updateMode() == ComputerControlInterface::UpdateMode::Monitoring ?
+			   MonitoringWeight : BasicWeight;
+}
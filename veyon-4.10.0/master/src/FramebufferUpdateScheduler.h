@@ -0,0 +1,79 @@
+/*
+ * FramebufferUpdateScheduler.h - declaration of FramebufferUpdateScheduler class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <QPointer>
+#include <QTimer>
+
+#include "ComputerControlInterface.h"
+
+class VeyonMaster;
+
+/**
+ * \brief Distributes a master-wide framebuffer update budget across all monitored computers
+ *
+ * Periodically divides the configured total update rate and decoding time per second
+ * between all monitored computers and derives a minimum update interval per computer.
+ * The share of each computer depends on its priority only (focused by the user, shown
+ * in Monitoring mode or Basic mode) while the measured decoding time per update merely
+ * caps the number of updates that fit into the share of the decoding time budget.
+ */
+class FramebufferUpdateScheduler : public QObject
+{
+	Q_OBJECT
+public:
+	explicit FramebufferUpdateScheduler( VeyonMaster& master );
+	~FramebufferUpdateScheduler() override = default;
+
+	static bool isEnabled();
+
+	void setFocusedComputerControlInterface( const ComputerControlInterface::Pointer& computerControlInterface );
+
+private:
+	static constexpr int SchedulingInterval = 1000;
+	static constexpr int MaximumUpdateInterval = 10000;
+	static constexpr int UpdateIntervalGranularity = 50;
+	static constexpr qint64 DefaultDecodeTime = 5 * 1000 * 1000; // ns
+	static constexpr int BasicWeight = 1;
+	static constexpr int MonitoringWeight = 2;
+	static constexpr int FocusedWeight = 8;
+
+	struct Host
+	{
+		qint64 decodeTimePerUpdate{DefaultDecodeTime};
+	};
+
+	void schedule();
+	int weight( ComputerControlInterface* computerControlInterface ) const;
+
+	VeyonMaster& m_master;
+	const int m_updateRateBudget;
+	const int m_decodeTimeBudget;
+
+	QTimer m_timer{this};
+	QHash<ComputerControlInterface *, Host> m_hosts{};
+	QPointer<ComputerControlInterface> m_focusedComputerControlInterface{};
+
+};
@@ -30,6 +30,7 @@
 #include "ComputerControlListModel.h"
 #include "ComputerMonitoringModel.h"
 #include "FeatureManager.h"
+#include "FramebufferUpdateScheduler.h"
 #include "VeyonConfiguration.h"
 #include "MainWindow.h"
 #include "ComputerManager.h"
@@ -75,6 +76,11 @@ VeyonMaster::VeyonMaster( QObject* parent ) :
 
 	m_localSessionControlInterface.start({}, ComputerControlInterface::UpdateMode::Disabled);
 
+	if (FramebufferUpdateScheduler::isEnabled())
+	{
+		m_framebufferUpdateScheduler = new FramebufferUpdateScheduler(*this);
+	}
+
 	// attach computer list model to proxy model
 	m_computerMonitoringModel->setSourceModel( m_computerControlListModel );
 	m_computerMonitoringModel->setSortRole( Qt::InitialSortOrderRole );
@@ -35,6 +35,7 @@ class BuiltinFeatures;
 class ComputerControlListModel;
 class ComputerManager;
 class ComputerMonitoringModel;
+class FramebufferUpdateScheduler;
 class MainWindow;
 class UserConfig;
 
@@ -65,6 +66,11 @@ public:
 		return m_computerMonitoringModel;
 	}
 
+	FramebufferUpdateScheduler* framebufferUpdateScheduler() const
+	{
+		return m_framebufferUpdateScheduler;
+	}
+
 	const FeatureList& features() const
 	{
 		return m_features;
@@ -109,6 +115,7 @@ private:
 	ComputerManager* m_computerManager;
 	ComputerControlListModel* m_computerControlListModel;
 	ComputerMonitoringModel* m_computerMonitoringModel;
+	FramebufferUpdateScheduler* m_framebufferUpdateScheduler{nullptr};
 
 	ComputerControlInterface m_localSessionControlInterface;
 
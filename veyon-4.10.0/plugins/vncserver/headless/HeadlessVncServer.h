@@ -97,6 +97,11 @@ public:
 		return {};
 	}
 
+	bool supportsFramebufferScaling() const override
+	{
+		return true;
+	}
+
 private:
 	static constexpr auto DefaultFramebufferWidth = 640;
 	static constexpr auto DefaultFramebufferHeight = 480;
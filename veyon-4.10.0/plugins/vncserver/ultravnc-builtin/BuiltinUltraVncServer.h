@@ -94,6 +94,11 @@ public:
 		return {};
 	}
 
+	bool supportsFramebufferScaling() const override
+	{
+		return true;
+	}
+
 	const UltraVncConfiguration& configuration() const
 	{
 		return m_configuration;
@@ -92,6 +92,11 @@ public:
 		return {};
 	}
 
+	bool supportsFramebufferScaling() const override
+	{
+		return true;
+	}
+
 private:
 	X11VncConfiguration m_configuration;
 
@@ -27,6 +27,7 @@
 #include "VeyonCore.h"
 #include "ComputerControlClient.h"
 #include "ComputerControlServer.h"
+#include "MonitoringMode.h"
 
 
 ComputerControlClient::ComputerControlClient( ComputerControlServer* server,
@@ -44,13 +45,21 @@ ComputerControlClient::ComputerControlClient( ComputerControlServer* server,
 	m_clientProtocol( vncServerSocket(), vncServerPassword )
 {
 	m_framebufferUpdateTimer.start();
+
+	m_deferredFramebufferUpdateRequestTimer.setSingleShot(true);
+	connect(&m_deferredFramebufferUpdateRequestTimer, &QTimer::timeout,
+			this, &ComputerControlClient::forwardDeferredFramebufferUpdateRequest);
 }
 
 
 
 ComputerControlClient::~ComputerControlClient()
 {
-	m_server->accessControlManager().removeClient( &m_serverClient );
+	// clients in worker threads already have been removed by ComputerControlServer
+	if( thread() == m_server->thread() )
+	{
+		m_server->accessControlManager().removeClient( &m_serverClient );
+	}
 }
 
 
@@ -65,7 +74,8 @@ bool ComputerControlClient::receiveClientMessage()
 		return false;
 	}
 
-	if( messageType == FeatureMessage::RfbMessageType )
+	if( messageType == FeatureMessage::RfbMessageType ||
+		messageType == FeatureMessage::CompactRfbMessageType )
 	{
 		return m_server->handleFeatureMessage(this);
 	}
@@ -84,13 +94,29 @@ bool ComputerControlClient::receiveClientMessage()
 		if (updateRequestMessage->incremental &&
 			m_framebufferUpdateTimer.hasExpired(m_minimumFramebufferUpdateInterval) == false)
 		{
-			// discard update request
+			// discard the request libvncclient sends after each update while updates are suspended
+			if (m_minimumFramebufferUpdateInterval >= MonitoringMode::SuspendedFramebufferUpdateInterval)
+			{
+				return true;
+			}
+
+			// defer update request until the interval has elapsed instead of making the
+			// client wait for its own next request
+			m_deferredFramebufferUpdateRequest = messageData;
+			if (m_deferredFramebufferUpdateRequestTimer.isActive() == false)
+			{
+				m_deferredFramebufferUpdateRequestTimer.start(
+					int(std::max<qint64>(0, m_minimumFramebufferUpdateInterval - m_framebufferUpdateTimer.elapsed())));
+			}
 			return true;
 		}
 
-		// forward request to server
+		// forward request to server - any deferred request is superseded by this one
+		m_deferredFramebufferUpdateRequestTimer.stop();
+		m_deferredFramebufferUpdateRequest.clear();
+
 		m_framebufferUpdateTimer.restart();
-		return vncServerSocket()->write(messageData) == messageData.size();
+		return forwardFramebufferUpdateRequest(messageData);
 	}
 
 	return VncProxyConnection::receiveClientMessage();
@@ -98,7 +124,106 @@ bool ComputerControlClient::receiveClientMessage()
 
 
 
+bool ComputerControlClient::receiveServerMessage()
+{
+	if (VncProxyConnection::receiveServerMessage() == false)
+	{
+		return false;
+	}
+
+	if (m_clientProtocol.lastMessageType() == rfbResizeFrameBuffer)
+	{
+		// the framebuffer size now reflects the requested scale (or a changed screen resolution),
+		// so commit the scale and re-evaluate the latest requested size based on it
+		if (m_pendingFramebufferScale > 0)
+		{
+			m_framebufferScale = std::exchange(m_pendingFramebufferScale, 0);
+		}
+
+		if (m_scaledFramebufferSize.isValid())
+		{
+			setScaledFramebufferSize(m_scaledFramebufferSize.width(), m_scaledFramebufferSize.height());
+		}
+	}
+	else if (m_pendingFramebufferScale > 0 &&
+			 m_pendingFramebufferScaleTimer.hasExpired(PendingFramebufferScaleTimeout))
+	{
+		// the VNC server did not resize the framebuffer in time (e.g. because it does not support
+		// scaling) so keep the current scale instead of blocking further scale changes forever
+		vDebug() << "VNC server did not apply framebuffer scale 1 /" << m_pendingFramebufferScale;
+		m_pendingFramebufferScale = 0;
+	}
+
+	return true;
+}
+
+
+
 void ComputerControlClient::setMinimumFramebufferUpdateInterval(int interval)
 {
 	m_minimumFramebufferUpdateInterval = interval;
+
+	if (m_minimumFramebufferUpdateInterval >= MonitoringMode::SuspendedFramebufferUpdateInterval)
+	{
+		m_deferredFramebufferUpdateRequestTimer.stop();
+		m_deferredFramebufferUpdateRequest.clear();
+	}
+	else if (m_deferredFramebufferUpdateRequestTimer.isActive())
+	{
+		m_deferredFramebufferUpdateRequestTimer.start(
+			int(std::max<qint64>(0, m_minimumFramebufferUpdateInterval - m_framebufferUpdateTimer.elapsed())));
+	}
+}
+
+
+
+void ComputerControlClient::forwardDeferredFramebufferUpdateRequest()
+{
+	if (m_deferredFramebufferUpdateRequest.isEmpty() == false)
+	{
+		m_framebufferUpdateTimer.restart();
+		forwardFramebufferUpdateRequest(std::exchange(m_deferredFramebufferUpdateRequest, {}));
+	}
+}
+
+
+
+void ComputerControlClient::setScaledFramebufferSize(int width, int height)
+{
+	if (m_clientProtocol.state() != VncClientProtocol::Running)
+	{
+		return;
+	}
+
+	m_scaledFramebufferSize = {width, height};
+
+	// the current framebuffer size is only known to correspond to m_framebufferScale once the
+	// VNC server acknowledged a previous scale change, therefore wait for it before rescaling
+	if (m_pendingFramebufferScale > 0)
+	{
+		if (m_pendingFramebufferScaleTimer.hasExpired(PendingFramebufferScaleTimeout) == false)
+		{
+			return;
+		}
+		m_pendingFramebufferScale = 0;
+	}
+
+	// the VNC server scales by integer divisors only, so choose the largest one which
+	// still results in a framebuffer not smaller than requested (or 1 to disable scaling)
+	auto scale = 1;
+	if (width > 0 && height > 0)
+	{
+		const auto nativeWidth = m_clientProtocol.framebufferWidth() * m_framebufferScale;
+		const auto nativeHeight = m_clientProtocol.framebufferHeight() * m_framebufferScale;
+
+		scale = qBound(1, std::min(nativeWidth / width, nativeHeight / height), MaximumFramebufferScale);
+	}
+
+	if (scale != m_framebufferScale &&
+		m_clientProtocol.sendFramebufferScale(uint8_t(scale)))
+	{
+		vDebug() << "scaling framebuffer by 1 /" << scale;
+		m_pendingFramebufferScale = scale;
+		m_pendingFramebufferScaleTimer.start();
+	}
 }
@@ -25,6 +25,9 @@
 #pragma once
 
 #include <QElapsedTimer>
+#include <QSize>
+
+#include <atomic>
 
 #include "VncClientProtocol.h"
 #include "VncProxyConnection.h"
@@ -47,13 +50,38 @@ public:
 	~ComputerControlClient() override;
 
 	bool receiveClientMessage() override;
+	bool receiveServerMessage() override;
 
 	VncServerClient* serverClient()
 	{
 		return &m_serverClient;
 	}
 
+	// continues the protocol as soon as the asynchronous access control has finished
+	void continueAfterAccessControl()
+	{
+		readFromClient();
+	}
+
 	void setMinimumFramebufferUpdateInterval(int interval);
+	void setScaledFramebufferSize(int width, int height);
+
+	// returns previous value so callers can coalesce queued calls across threads
+	bool setAsyncFeatureMessagesPending(bool pending)
+	{
+		return m_asyncFeatureMessagesPending.exchange(pending);
+	}
+
+	// replies are sent in the compact format once the client has used it itself
+	bool compactFeatureMessages() const
+	{
+		return m_compactFeatureMessages;
+	}
+
+	void setCompactFeatureMessages(bool enabled)
+	{
+		m_compactFeatureMessages = enabled;
+	}
 
 protected:
 	VncClientProtocol& clientProtocol() override
@@ -67,6 +95,8 @@ protected:
 	}
 
 private:
+	void forwardDeferredFramebufferUpdateRequest();
+
 	ComputerControlServer* m_server;
 
 	VncServerClient m_serverClient;
@@ -76,5 +106,17 @@ private:
 
 	int m_minimumFramebufferUpdateInterval{-1};
 	QElapsedTimer m_framebufferUpdateTimer;
+	QTimer m_deferredFramebufferUpdateRequestTimer{this};
+	QByteArray m_deferredFramebufferUpdateRequest{};
+
+	static constexpr int MaximumFramebufferScale = 16;
+	static constexpr int PendingFramebufferScaleTimeout = 3000;
+	int m_framebufferScale{1};
+	int m_pendingFramebufferScale{0};
+	QElapsedTimer m_pendingFramebufferScaleTimer;
+	QSize m_scaledFramebufferSize{};
+
+	std::atomic_bool m_asyncFeatureMessagesPending{false};
+	std::atomic_bool m_compactFeatureMessages{false};
 
 } ;
@@ -23,6 +23,7 @@
  */
 
 #include <QCoreApplication>
+#include <QThread>
 
 #include "AccessControlProvider.h"
 #include "BuiltinFeatures.h"
@@ -31,6 +32,7 @@
 #include "FeatureManager.h"
 #include "FeatureMessage.h"
 #include "HostAddress.h"
+#include "MonitoringMode.h"
 #include "PlatformPluginInterface.h"
 #include "VeyonConfiguration.h"
 #include "SystemTrayIcon.h"
@@ -60,10 +62,19 @@ ComputerControlServer::ComputerControlServer( QObject* parent ) :
 
 	connect( &m_serverAccessControlManager, &ServerAccessControlManager::finished,
 			 this, &ComputerControlServer::showAccessControlMessage );
+	connect( &m_serverAccessControlManager, &ServerAccessControlManager::finished,
+			 this, &ComputerControlServer::continueAfterAccessControl );
+	connect( &m_serverAccessControlManager, &ServerAccessControlManager::accessRevoked,
+			 this, &ComputerControlServer::closeRevokedConnection );
 
 	connect(&m_vncProxyServer, &VncProxyServer::serverMessageProcessed,
 			 this, &ComputerControlServer::sendAsyncFeatureMessages, Qt::DirectConnection);
-	connect( &m_vncProxyServer, &VncProxyServer::connectionClosed, this, &ComputerControlServer::updateTrayIconToolTip );
+	connect( &m_vncProxyServer, &VncProxyServer::connectionClosed, this, &ComputerControlServer::handleConnectionClosed );
+
+	connect(&m_featureWorkerManager, &FeatureWorkerManager::workersChanged,
+			&VeyonCore::builtinFeatures().monitoringMode(), &MonitoringMode::scheduleActiveFeaturesUpdate);
+	connect(&VeyonCore::builtinFeatures().monitoringMode(), &MonitoringMode::stateChanged,
+			this, &ComputerControlServer::pushAsyncFeatureMessages);
 }
 
 
@@ -127,39 +138,131 @@ bool ComputerControlServer::handleFeatureMessage(ComputerControlClient* client)
 		return false;
 	}
 
-	if (featureMessage.receive(socket) == false)
+	if (messageType == FeatureMessage::CompactRfbMessageType)
+	{
+		if (featureMessage.receiveCompact(socket) == false)
+		{
+			return false;
+		}
+
+		client->setCompactFeatureMessages(true);
+	}
+	else if (featureMessage.receive(socket) == false)
 	{
 		return false;
 	}
 
-	VeyonCore::featureManager().handleFeatureMessage( *this, MessageContext{socket, client}, featureMessage );
+	if (client->thread() != thread())
+	{
+		// connection is served by a worker thread while features have to be handled in the main thread
+		QMetaObject::invokeMethod(this, [=]() {
+			if (m_vncProxyServer.clients().contains(client))
+			{
+				processFeatureMessage(MessageContext{socket, client}, featureMessage);
+			}
+		}, Qt::QueuedConnection);
+
+		return true;
+	}
+
+	processFeatureMessage(MessageContext{socket, client}, featureMessage);
 
 	return true;
 }
 
 
 
+void ComputerControlServer::processFeatureMessage(const MessageContext& context, const FeatureMessage& featureMessage)
+{
+	VeyonCore::featureManager().handleFeatureMessage(*this, context, featureMessage);
+
+	// feature messages are the main cause for changes of active features so let the
+	// monitoring mode re-evaluate them instead of waiting for its next periodic update
+	VeyonCore::builtinFeatures().monitoringMode().scheduleActiveFeaturesUpdate();
+}
+
+
+
 bool ComputerControlServer::sendFeatureMessageReply( const MessageContext& context, const FeatureMessage& reply )
 {
 	vDebug() << reply;
 
-	if (context.ioDevice())
+	const auto client = findClient(context);
+	if (client == nullptr)
+	{
+		return false;
+	}
+
+	const auto compact = client->compactFeatureMessages();
+
+	if (client->thread() != QThread::currentThread())
+	{
+		// connection is served by a worker thread, so let it write the message itself - the
+		// queued call is dropped automatically if the connection is deleted in the meantime
+		QMetaObject::invokeMethod(client, [client, message = compact ? reply.toCompactRfbMessage() : reply.toRfbMessage()]() {
+			client->proxyClientSocket()->write(message);
+		}, Qt::QueuedConnection);
+
+		return true;
+	}
+
+	if (compact)
 	{
-		return reply.sendAsRfbMessage(context.ioDevice());
+		const auto message = reply.toCompactRfbMessage();
+		return client->proxyClientSocket()->write(message) == message.size();
 	}
 
-	return false;
+	return reply.sendAsRfbMessage(client->proxyClientSocket());
 }
 
 
 
 void ComputerControlServer::setMinimumFramebufferUpdateInterval(const MessageContext& context, int interval)
 {
-	auto client = qobject_cast<ComputerControlClient *>(context.connection());
+	auto client = findClient(context);
 	if (client)
 	{
-		client->setMinimumFramebufferUpdateInterval(interval);
+		QMetaObject::invokeMethod(client, [=]() { client->setMinimumFramebufferUpdateInterval(interval); });
+	}
+}
+
+
+
+void ComputerControlServer::setScaledFramebufferSize(const MessageContext& context, int width, int height)
+{
+	if (m_vncServer.supportsFramebufferScaling() == false)
+	{
+		return;
+	}
+
+	auto client = findClient(context);
+	if (client)
+	{
+		QMetaObject::invokeMethod(client, [=]() { client->setScaledFramebufferSize(width, height); });
+	}
+}
+
+
+
+ComputerControlClient* ComputerControlServer::findClient(const MessageContext& context) const
+{
+	// connections served by worker threads are deleted there once they have been closed, so only
+	// connections still known to the proxy server may be dereferenced in the main thread
+	const auto connection = context.connection();
+	if (connection == nullptr)
+	{
+		return nullptr;
+	}
+
+	for (auto client : m_vncProxyServer.clients())
+	{
+		if (client == connection)
+		{
+			return qobject_cast<ComputerControlClient *>(client);
+		}
 	}
+
+	return nullptr;
 }
 
 
@@ -256,6 +359,44 @@ void ComputerControlServer::showAccessControlMessage( VncServerClient* client )
 
 
 
+void ComputerControlServer::continueAfterAccessControl( VncServerClient* serverClient )
+{
+	for( auto connection : m_vncProxyServer.clients() )
+	{
+		auto client = qobject_cast<ComputerControlClient *>( connection );
+		if( client && client->serverClient() == serverClient )
+		{
+			// the result may have been available immediately, so let the client
+			// finish its current protocol read first
+			QMetaObject::invokeMethod( client, &ComputerControlClient::continueAfterAccessControl, Qt::QueuedConnection );
+			return;
+		}
+	}
+}
+
+
+
+void ComputerControlServer::closeRevokedConnection( VncServerClient* serverClient )
+{
+	for( auto connection : m_vncProxyServer.clients() )
+	{
+		auto client = qobject_cast<ComputerControlClient *>( connection );
+		if( client && client->serverClient() == serverClient )
+		{
+			// the client's state must only be changed in the thread serving the connection
+			QMetaObject::invokeMethod( client, [client]() {
+				vDebug() << "closing connection as client does not pass access control any longer";
+				client->serverClient()->setAccessControlState( VncServerClient::AccessControlState::Failed );
+				client->serverClient()->setProtocolState( VncServerProtocol::State::Close );
+				client->continueAfterAccessControl();
+			}, Qt::QueuedConnection );
+			return;
+		}
+	}
+}
+
+
+
 QFutureWatcher<void>* ComputerControlServer::resolveFQDNs( const QStringList& hosts )
 {
 	auto watcher = new QFutureWatcher<void>();
@@ -280,7 +421,57 @@ QFutureWatcher<void>* ComputerControlServer::resolveFQDNs( const QStringList& ho
 
 void ComputerControlServer::sendAsyncFeatureMessages(VncProxyConnection* connection)
 {
-	VeyonCore::featureManager().sendAsyncFeatureMessages(*this, MessageContext{connection->proxyClientSocket()});
+	if (connection->thread() == thread())
+	{
+		VeyonCore::featureManager().sendAsyncFeatureMessages(*this, MessageContext{connection->proxyClientSocket(), connection});
+		return;
+	}
+
+	// called from a worker thread after each server message, so queue at most one call per connection
+	auto client = qobject_cast<ComputerControlClient *>(connection);
+	if (client == nullptr || client->setAsyncFeatureMessagesPending(true))
+	{
+		return;
+	}
+
+	QMetaObject::invokeMethod(this, [=]() {
+		if (m_vncProxyServer.clients().contains(connection))
+		{
+			client->setAsyncFeatureMessagesPending(false);
+			VeyonCore::featureManager().sendAsyncFeatureMessages(*this, MessageContext{connection->proxyClientSocket(), connection});
+		}
+	}, Qt::QueuedConnection);
+}
+
+
+
+void ComputerControlServer::pushAsyncFeatureMessages()
+{
+	for (auto connection : m_vncProxyServer.clients())
+	{
+		// feature messages must not interfere with the protocol initialization
+		if (connection->isEstablished())
+		{
+			sendAsyncFeatureMessages(connection);
+		}
+	}
+}
+
+
+
+void ComputerControlServer::handleConnectionClosed(VncProxyConnection* connection)
+{
+	// the connection is still alive at this point but gets deleted in its own thread afterwards
+	VeyonCore::builtinFeatures().monitoringMode().removeClient(connection);
+
+	// clients of worker threads must not access the access control manager when being destroyed
+	auto client = qobject_cast<ComputerControlClient *>(connection);
+	if (client && client->thread() != thread())
+	{
+		m_serverAccessControlManager.removeClient(client->serverClient());
+	}
+
+	updateTrayIconToolTip();
 }
 
 
@@ -78,13 +78,22 @@ public:
 
 	void setMinimumFramebufferUpdateInterval(const MessageContext& context, int interval) override;
 
+	void setScaledFramebufferSize(const MessageContext& context, int width, int height) override;
+
 private:
+	ComputerControlClient* findClient(const MessageContext& context) const;
+
 	void checkForIncompleteAuthentication( VncServerClient* client );
 	void showAuthenticationMessage( VncServerClient* client );
 	void showAccessControlMessage( VncServerClient* client );
+	void continueAfterAccessControl( VncServerClient* serverClient );
+	void closeRevokedConnection( VncServerClient* serverClient );
 	QFutureWatcher<void>* resolveFQDNs( const QStringList& hosts );
 
+	void processFeatureMessage(const MessageContext& context, const FeatureMessage& featureMessage);
 	void sendAsyncFeatureMessages(VncProxyConnection* connection);
+	void pushAsyncFeatureMessages();
+	void handleConnectionClosed(VncProxyConnection* connection);
 	void updateTrayIconToolTip();
 
 	QMutex m_dataMutex;
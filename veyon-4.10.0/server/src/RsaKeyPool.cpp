@@ -0,0 +1,97 @@
+/*
+ * RsaKeyPool.cpp - implementation of RsaKeyPool
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "RsaKeyPool.h"
+
+
+RsaKeyPool::RsaKeyPool( int size ) :
+	m_size( size )
+{
+	// generate keys one after another in the background
+	m_threadPool.setMaxThreadCount( 1 );
+
+	refill();
+}
+
+
+
+RsaKeyPool::~RsaKeyPool()
+{
+	m_threadPool.clear();
+	m_threadPool.waitForDone();
+}
+
+
+
+CryptoCore::PrivateKey RsaKeyPool::take()
+{
+	CryptoCore::PrivateKey key;
+
+	m_mutex.lock();
+	if( m_keys.isEmpty() == false )
+	{
+		key = m_keys.dequeue();
+	}
+	m_mutex.unlock();
+
+	refill();
+
+	if( key.isNull() )
+	{
+		vDebug() << "no pre-generated key available";
+		key = generateKey();
+	}
+
+	return key;
+}
+
+
+
+void RsaKeyPool::refill()
+{
+	QMutexLocker locker( &m_mutex );
+
+	while( m_keys.size() + m_pendingKeys < m_size )
+	{
+		++m_pendingKeys;
+
+		m_threadPool.start( [this]() {
+			const auto key = generateKey();
+
+			QMutexLocker locker( &m_mutex );
+			--m_pendingKeys;
+			if( key.isNull() == false )
+			{
+				m_keys.enqueue( key );
+			}
+		} );
+	}
+}
+
+
+
+CryptoCore::PrivateKey RsaKeyPool::generateKey()
+{
+	return CryptoCore::KeyGenerator().createRSA( CryptoCore::RsaKeySize );
+}
@@ -0,0 +1,55 @@
+/*
+ * RsaKeyPool.h - header file for RsaKeyPool
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <QMutex>
+#include <QQueue>
+#include <QThreadPool>
+
+#include "CryptoCore.h"
+
+// provides pre-generated ephemeral RSA keys so that generating a key does not
+// block the authentication of incoming connections
+class RsaKeyPool
+{
+public:
+	explicit RsaKeyPool( int size );
+	~RsaKeyPool();
+
+	CryptoCore::PrivateKey take();
+
+private:
+	void refill();
+
+	static CryptoCore::PrivateKey generateKey();
+
+	const int m_size;
+
+	QThreadPool m_threadPool{};
+	QMutex m_mutex{};
+	QQueue<CryptoCore::PrivateKey> m_keys{};
+	int m_pendingKeys{0};
+
+} ;
@@ -22,12 +22,19 @@
  *
  */
 
+#include <QDateTime>
+
 #include "VeyonCore.h"
 
 #include "BuiltinFeatures.h"
 #include "ServerAccessControlManager.h"
 #include "AccessControlProvider.h"
 #include "DesktopAccessDialog.h"
+#include "NetworkObjectDirectory.h"
+#include "NetworkObjectDirectoryManager.h"
+#include "PlatformPluginInterface.h"
+#include "PlatformUserFunctions.h"
+#include "VeyonConfiguration.h"
 
 
 ServerAccessControlManager::ServerAccessControlManager( FeatureWorkerManager& featureWorkerManager,
@@ -37,8 +44,25 @@ ServerAccessControlManager::ServerAccessControlManager( FeatureWorkerManager& fe
 	m_featureWorkerManager( featureWorkerManager ),
 	m_desktopAccessDialog( desktopAccessDialog ),
 	m_clients(),
-	m_desktopAccessChoices()
+	m_desktopAccessChoices(),
+	m_resultCacheLifetime( VeyonCore::config().accessControlResultCacheLifetime() )
 {
+	// keep the thread alive as it holds the instances used for evaluation
+	m_evaluationThreadPool.setMaxThreadCount( 1 );
+	m_evaluationThreadPool.setExpiryTimeout( -1 );
+}
+
+
+
+ServerAccessControlManager::~ServerAccessControlManager()
+{
+	// instances used for evaluation have to be destroyed in their thread
+	m_evaluationThreadPool.start( [this]() {
+		delete m_evaluationAccessControlProvider;
+		delete m_evaluationNetworkObjectDirectory;
+	} );
+
+	m_evaluationThreadPool.waitForDone();
 }
 
 
@@ -49,11 +73,13 @@ void ServerAccessControlManager::addClient( VncServerClient* client )
 	{
 	case RfbVeyonAuth::KeyFile:
 	case RfbVeyonAuth::Logon:
+	case RfbVeyonAuth::SessionTicket:
 		performAccessControl( client );
 		break;
 
 	case RfbVeyonAuth::Token:
 		client->setAccessControlState( VncServerClient::AccessControlState::Successful );
+		m_clients.append( client );
 		break;
 
 	default:
@@ -62,11 +88,6 @@ void ServerAccessControlManager::addClient( VncServerClient* client )
 		client->setAccessControlDetails(tr("Requested authentication method not available"));
 		break;
 	}
-
-	if( client->accessControlState() == VncServerClient::AccessControlState::Successful )
-	{
-		m_clients.append( client );
-	}
 }
 
 
@@ -75,24 +96,35 @@ void ServerAccessControlManager::removeClient( VncServerClient* client )
 {
 	m_clients.removeAll( client );
 
+	m_pendingClients.erase( std::remove_if( m_pendingClients.begin(), m_pendingClients.end(),
+											[client]( const PendingClient& pendingClient ) {
+												return pendingClient.client == client;
+											} ), m_pendingClients.end() );
+
+	if( m_evaluatedClient.client == client )
+	{
+		m_evaluatedClient = {};
+	}
+
 	// force all remaining clients to pass access control again as conditions might
 	// have changed (e.g. AccessControlRule::Condition::AccessFromAlreadyConnectedUser)
-
+	// while keeping their state until the new result is available
 	const VncServerClientList previousClients = m_clients;
 	m_clients.clear();
 
-	for( auto prevClient : std::as_const( previousClients ) )
+	for( auto prevClient : previousClients )
 	{
-		prevClient->setAccessControlState( VncServerClient::AccessControlState::Init );
-		addClient( prevClient );
-
-		if( prevClient->accessControlState() != VncServerClient::AccessControlState::Successful &&
-				prevClient->accessControlState() != VncServerClient::AccessControlState::Pending )
+		if( prevClient->authType() == RfbVeyonAuth::Token )
 		{
-			vDebug() << "closing connection as client does not pass access control any longer";
-			prevClient->setProtocolState( VncServerProtocol::State::Close );
+			m_clients.append( prevClient );
+		}
+		else
+		{
+			m_pendingClients.append( { prevClient, true } );
 		}
 	}
+
+	evaluateNextClient();
 }
 
 
@@ -117,11 +149,140 @@ void ServerAccessControlManager::performAccessControl( VncServerClient* client )
 		break;
 	}
 
-	const auto checkResult = VeyonCore::builtinFeatures().accessControlProvider()
-							 .checkAccess(client->username(),
-										  client->hostAddress(),
-										  connectedUsers());
+	client->setAccessControlState( VncServerClient::AccessControlState::Pending );
+
+	m_pendingClients.append( { client, false } );
+
+	evaluateNextClient();
+}
+
+
+
+void ServerAccessControlManager::evaluateNextClient()
+{
+	// evaluate clients strictly one after another so that each evaluation sees
+	// the users of all clients which have been granted access before
+	while( m_evaluationActive == false && m_pendingClients.isEmpty() == false )
+	{
+		const auto pendingClient = m_pendingClients.takeFirst();
+
+		const auto username = pendingClient.client->username();
+		const auto hostAddress = pendingClient.client->hostAddress();
+		auto users = connectedUsers();
+		std::sort( users.begin(), users.end() );
+
+		// rules may depend on the locally logged on user
+		const auto localUser = VeyonCore::platform().userFunctions().currentUser();
+		flushResultCacheOnSessionChange( localUser );
+
+		const auto cacheKey = QStringList{ username, hostAddress, localUser, users.join( QLatin1Char(',') ) }.join( QLatin1Char('\n') );
+		const auto cachedResult = m_resultCache.constFind( cacheKey );
+		if( cachedResult != m_resultCache.constEnd() &&
+			cachedResult->expirationTime > QDateTime::currentMSecsSinceEpoch() )
+		{
+			finishEvaluation( pendingClient, cachedResult->checkResult );
+			continue;
+		}
+
+		m_evaluatedClient = pendingClient;
+		m_evaluationActive = true;
+
+		m_evaluationThreadPool.start( [=]() {
+			const auto checkResult = evaluationAccessControlProvider().checkAccess( username, hostAddress, users );
+
+			QMetaObject::invokeMethod( this, [=]() {
+				m_evaluationActive = false;
+
+				if( m_resultCacheLifetime > 0 )
+				{
+					m_resultCache[cacheKey] = { checkResult, QDateTime::currentMSecsSinceEpoch() + qint64( m_resultCacheLifetime ) * 1000 };
+				}
+
+				// client has been removed in the meantime if reset
+				if( m_evaluatedClient.client )
+				{
+					finishEvaluation( std::exchange( m_evaluatedClient, {} ), checkResult );
+				}
+
+				evaluateNextClient();
+			}, Qt::QueuedConnection );
+		} );
+	}
+}
 
+
+
+AccessControlProvider& ServerAccessControlManager::evaluationAccessControlProvider()
+{
+	// called in the evaluation thread only - the network object directory is not thread-safe,
+	// so use an instance of its own there while user group backends are not used by the
+	// server in any other thread
+	if( m_evaluationAccessControlProvider == nullptr )
+	{
+		m_evaluationNetworkObjectDirectory = VeyonCore::networkObjectDirectoryManager().createDirectory(
+			VeyonCore::config().networkObjectDirectoryPlugin(), nullptr );
+		m_evaluationAccessControlProvider = new AccessControlProvider( m_evaluationNetworkObjectDirectory );
+	}
+
+	return *m_evaluationAccessControlProvider;
+}
+
+
+
+void ServerAccessControlManager::finishEvaluation( const PendingClient& pendingClient,
+												   const AccessControlProvider::CheckResult& checkResult )
+{
+	if( pendingClient.reevaluation == false )
+	{
+		finishAccessControl( pendingClient.client, checkResult );
+		return;
+	}
+
+	// clients which have been granted access before keep it unless they are denied
+	// access now or the user has chosen to never grant access to them
+	const auto choice = m_desktopAccessChoices.value( HostUserPair( pendingClient.client->username(),
+																	pendingClient.client->hostAddress() ),
+													  DesktopAccessDialog::ChoiceNone );
+
+	if( checkResult.access == AccessControlProvider::Access::Allow ||
+		( checkResult.access == AccessControlProvider::Access::ToBeConfirmed &&
+		  choice != DesktopAccessDialog::ChoiceNever ) )
+	{
+		m_clients.append( pendingClient.client );
+	}
+	else
+	{
+		// the client may be served by another thread, so let its owner close it
+		Q_EMIT accessRevoked( pendingClient.client );
+	}
+}
+
+
+
+void ServerAccessControlManager::flushResultCacheOnSessionChange( const QString& localUser )
+{
+	if( m_resultCacheLifetime <= 0 )
+	{
+		return;
+	}
+
+	// a decreased uptime indicates a new session even if the same user logged on again
+	const auto sessionUptime = VeyonCore::platform().sessionFunctions().currentSessionUptime();
+
+	if( localUser != m_resultCacheLocalUser || sessionUptime < m_resultCacheSessionUptime )
+	{
+		m_resultCache.clear();
+		m_resultCacheLocalUser = localUser;
+	}
+
+	m_resultCacheSessionUptime = sessionUptime;
+}
+
+
+
+void ServerAccessControlManager::finishAccessControl( VncServerClient* client,
+													  const AccessControlProvider::CheckResult& checkResult )
+{
 	switch (checkResult.access)
 	{
 	case AccessControlProvider::Access::Allow:
@@ -154,6 +315,11 @@ void ServerAccessControlManager::performAccessControl( VncServerClient* client )
 		break;
 	}
 
+	if( client->accessControlState() == VncServerClient::AccessControlState::Successful )
+	{
+		m_clients.append( client );
+	}
+
 	Q_EMIT finished( client );
 }
 
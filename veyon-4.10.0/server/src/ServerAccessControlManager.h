@@ -24,7 +24,11 @@
 
 #pragma once
 
+#include <QThreadPool>
+
+#include "AccessControlProvider.h"
 #include "DesktopAccessDialog.h"
+#include "PlatformSessionFunctions.h"
 #include "VncServerClient.h"
 
 class VariantArrayMessage;
@@ -36,6 +40,7 @@ public:
 	ServerAccessControlManager( FeatureWorkerManager& featureWorkerManager,
 								DesktopAccessDialog& desktopAccessDialog,
 								QObject* parent );
+	~ServerAccessControlManager() override;
 
 	void addClient( VncServerClient* client );
 	void removeClient( VncServerClient* client );
@@ -43,11 +48,23 @@ public:
 
 Q_SIGNALS:
 	void finished( VncServerClient* client );
+	void accessRevoked( VncServerClient* client );
 
 private:
 	static constexpr int ClientWaitInterval = 1000;
 
 	void performAccessControl( VncServerClient* client );
+	struct PendingClient
+	{
+		VncServerClient* client{nullptr};
+		bool reevaluation{false};
+	};
+
+	void evaluateNextClient();
+	AccessControlProvider& evaluationAccessControlProvider();
+	void finishEvaluation( const PendingClient& pendingClient, const AccessControlProvider::CheckResult& checkResult );
+	void flushResultCacheOnSessionChange( const QString& localUser );
+	void finishAccessControl( VncServerClient* client, const AccessControlProvider::CheckResult& checkResult );
 	VncServerClient::AccessControlState confirmDesktopAccess( VncServerClient* client );
 	void finishDesktopAccessConfirmation( VncServerClient* client );
 
@@ -58,6 +75,27 @@ private:
 
 	VncServerClientList m_clients;
 
+	// rules are evaluated one after another in a background thread as they might
+	// involve slow directory or user group queries - clients are removed from the
+	// queue before they get destroyed so no guarded pointers are required
+	QThreadPool m_evaluationThreadPool{};
+	NetworkObjectDirectory* m_evaluationNetworkObjectDirectory{nullptr};
+	AccessControlProvider* m_evaluationAccessControlProvider{nullptr};
+	QList<PendingClient> m_pendingClients{};
+	PendingClient m_evaluatedClient{};
+	bool m_evaluationActive{false};
+
+	struct CachedCheckResult
+	{
+		AccessControlProvider::CheckResult checkResult{};
+		qint64 expirationTime{0};
+	};
+
+	const int m_resultCacheLifetime;
+	QHash<QString, CachedCheckResult> m_resultCache{};
+	QString m_resultCacheLocalUser{};
+	PlatformSessionFunctions::SessionUptime m_resultCacheSessionUptime{PlatformSessionFunctions::InvalidSessionUptime};
+
 	using HostUserPair = QPair<QString, QString>;
 	using DesktopAccessChoiceMap = QMap<HostUserPair, DesktopAccessDialog::Choice>;
 
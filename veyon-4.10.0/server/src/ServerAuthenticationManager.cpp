@@ -22,6 +22,10 @@
  *
  */
 
+#include <QDataStream>
+#include <QFileInfo>
+#include <QMessageAuthenticationCode>
+
 #include "AuthenticationCredentials.h"
 #include "ServerAuthenticationManager.h"
 #include "CryptoCore.h"
@@ -32,7 +36,12 @@
 
 
 ServerAuthenticationManager::ServerAuthenticationManager( QObject* parent ) :
-	QObject( parent )
+	QObject( parent ),
+	m_sessionTicketLifetime( qBound( 0, VeyonCore::config().sessionTicketLifetime(), int(RfbVeyonAuth::MaximumSessionTicketLifetime) ) ),
+	m_sessionTicketKey( CryptoCore::generateChallenge() ),
+	m_sessionTicketSecretKey( CryptoCore::generateChallenge() ),
+	m_logonKeyPool( VeyonCore::config().authenticationMethod() == VeyonCore::AuthenticationMethod::LogonAuthentication ?
+						LogonKeyPoolSize : 0 )
 {
 }
 
@@ -57,6 +66,11 @@ QVector<RfbVeyonAuth::Type> ServerAuthenticationManager::supportedAuthTypes() co
 		authTypes.append( RfbVeyonAuth::Token );
 	}
 
+	if( m_sessionTicketLifetime > 0 && authTypes.isEmpty() == false )
+	{
+		authTypes.append( RfbVeyonAuth::SessionTicket );
+	}
+
 	return authTypes;
 }
 
@@ -85,12 +99,30 @@ void ServerAuthenticationManager::processAuthenticationMessage( VncServerClient*
 		client->setAuthState( performTokenAuthentication( client, message ) );
 		break;
 
+	case RfbVeyonAuth::SessionTicket:
+		client->setAuthState( performSessionTicketAuthentication( client, message ) );
+		break;
+
 	default:
 		// unknown or unsupported auth type
 		client->setAuthState( VncServerClient::AuthState::Failed );
 		break;
 	}
 
+	if( client->authState() == VncServerClient::AuthState::Successful &&
+		client->isSessionTicketRequested() &&
+		sendSessionTicket( client, message.ioDevice() ) == false )
+	{
+		client->setAuthState( VncServerClient::AuthState::Failed );
+	}
+
+	if( client->authState() == VncServerClient::AuthState::Successful ||
+		client->authState() == VncServerClient::AuthState::Failed )
+	{
+		client->setSessionTicketKey( {} );
+		client->setPublicKey( {} );
+	}
+
 	switch( client->authState() )
 	{
 	case VncServerClient::AuthState::Failed:
@@ -135,7 +167,7 @@ VncServerClient::AuthState ServerAuthenticationManager::performKeyAuthentication
 
 		const auto publicKeyPath = VeyonCore::filesystem().publicKeyPath( authKeyName );
 
-		CryptoCore::PublicKey publicKey( publicKeyPath );
+		auto publicKey = loadPublicKey( publicKeyPath );
 		if( publicKey.isNull() || publicKey.isPublic() == false )
 		{
 			vWarning() << "failed to load public key from" << publicKeyPath;
@@ -149,6 +181,9 @@ VncServerClient::AuthState ServerAuthenticationManager::performKeyAuthentication
 			return VncServerClient::AuthState::Failed;
 		}
 
+		// allows encrypting the secret of a requested session ticket for the client
+		client->setPublicKey( publicKey );
+
 		vDebug() << "SUCCESS";
 		return VncServerClient::AuthState::Successful;
 	}
@@ -168,7 +203,7 @@ VncServerClient::AuthState ServerAuthenticationManager::performLogonAuthenticati
 	switch( client->authState() )
 	{
 	case VncServerClient::AuthState::Init:
-		client->setPrivateKey( CryptoCore::KeyGenerator().createRSA( CryptoCore::RsaKeySize ) );
+		client->setPrivateKey( m_logonKeyPool.take() );
 
 		if( VariantArrayMessage( message.ioDevice() ).write( client->privateKey().toPublicKey().toPEM() ).send() )
 		{
@@ -183,6 +218,7 @@ VncServerClient::AuthState ServerAuthenticationManager::performLogonAuthenticati
 		auto privateKey = client->privateKey();
 
 		CryptoCore::SecureArray encryptedPassword( message.read().toByteArray() ); // Flawfinder: ignore
+		CryptoCore::SecureArray encryptedSessionTicketKey( message.read().toByteArray() ); // Flawfinder: ignore
 
 		CryptoCore::SecureArray decryptedPassword;
 
@@ -198,6 +234,17 @@ VncServerClient::AuthState ServerAuthenticationManager::performLogonAuthenticati
 
 		if( VeyonCore::platform().userFunctions().authenticate( client->username(), decryptedPassword ) )
 		{
+			// the client sends a random key along with the password for protecting the secret of
+			// a requested session ticket - without it no usable ticket is issued
+			CryptoCore::SecureArray sessionTicketKey;
+			if( client->isSessionTicketRequested() &&
+				encryptedSessionTicketKey.isEmpty() == false &&
+				privateKey.decrypt( encryptedSessionTicketKey, &sessionTicketKey,
+									CryptoCore::DefaultEncryptionAlgorithm ) )
+			{
+				client->setSessionTicketKey( sessionTicketKey.toByteArray() );
+			}
+
 			vDebug() << "SUCCESS";
 			return VncServerClient::AuthState::Successful;
 		}
@@ -244,3 +291,203 @@ VncServerClient::AuthState ServerAuthenticationManager::performTokenAuthenticati
 
 	return VncServerClient::AuthState::Failed;
 }
+
+
+
+VncServerClient::AuthState ServerAuthenticationManager::performSessionTicketAuthentication( VncServerClient* client,
+																							VariantArrayMessage& message )
+{
+	switch( client->authState() )
+	{
+	case VncServerClient::AuthState::Init:
+		// the ticket itself is not secret, so the client has to prove that it knows the
+		// ticket secret which it received in encrypted form along with the ticket
+		client->setChallenge( CryptoCore::generateChallenge() );
+		if( VariantArrayMessage( message.ioDevice() ).write( client->challenge() ).send() == false )
+		{
+			vWarning() << "failed to send challenge";
+			return VncServerClient::AuthState::Failed;
+		}
+		return VncServerClient::AuthState::SessionTicket;
+
+	case VncServerClient::AuthState::SessionTicket:
+	{
+		const auto ticket = message.read().toByteArray(); // Flawfinder: ignore
+		const auto proof = message.read().toByteArray(); // Flawfinder: ignore
+
+		if( ticket.size() <= SessionTicketMacSize || ticket.size() > MaximumSessionTicketSize )
+		{
+			vDebug() << "invalid session ticket";
+			return VncServerClient::AuthState::Failed;
+		}
+
+		// verify integrity before parsing any of the data provided by the client
+		const auto payload = ticket.left( ticket.size() - SessionTicketMacSize );
+		if( isEqualMac( ticket.right( SessionTicketMacSize ), sessionTicketMac( payload ) ) == false )
+		{
+			vDebug() << "invalid session ticket";
+			return VncServerClient::AuthState::Failed;
+		}
+
+		const auto secret = sessionTicketSecret( ticket );
+		if( isEqualMac( proof, QMessageAuthenticationCode::hash( client->challenge(), secret,
+																 QCryptographicHash::Sha256 ) ) == false )
+		{
+			vDebug() << "invalid proof of session ticket possession";
+			return VncServerClient::AuthState::Failed;
+		}
+
+		QDataStream stream( payload );
+		QByteArray ticketId;
+		QString username;
+		QString hostAddress;
+		qint64 expirationTime = 0;
+		stream >> ticketId >> username >> hostAddress >> expirationTime;
+
+		const auto now = QDateTime::currentMSecsSinceEpoch();
+
+		if( stream.status() != QDataStream::Ok ||
+			username != client->username() ||
+			hostAddress != client->hostAddress() ||
+			expirationTime < now )
+		{
+			vDebug() << "FAIL";
+			return VncServerClient::AuthState::Failed;
+		}
+
+		// each ticket can be used once only
+		for( auto it = m_consumedSessionTickets.begin(); it != m_consumedSessionTickets.end(); )
+		{
+			if( it.value() < now )
+			{
+				it = m_consumedSessionTickets.erase( it );
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		if( m_consumedSessionTickets.contains( ticketId ) )
+		{
+			vWarning() << "session ticket of user" << username << "from" << hostAddress << "has been used before";
+			return VncServerClient::AuthState::Failed;
+		}
+
+		m_consumedSessionTickets.insert( ticketId, expirationTime );
+
+		// the secret of the consumed ticket protects the secret of the renewed ticket
+		client->setSessionTicketKey( secret );
+
+		vDebug() << "SUCCESS";
+		return VncServerClient::AuthState::Successful;
+	}
+
+	default:
+		break;
+	}
+
+	return VncServerClient::AuthState::Failed;
+}
+
+
+
+bool ServerAuthenticationManager::sendSessionTicket( VncServerClient* client, QIODevice* ioDevice )
+{
+	// ticket is bound to user and host and can only be verified by this server instance
+	QByteArray payload;
+	QDataStream stream( &payload, QIODevice::WriteOnly );
+	stream << CryptoCore::generateChallenge().left( SessionTicketIdSize )
+		   << client->username() << client->hostAddress()
+		   << QDateTime::currentMSecsSinceEpoch() + qint64( m_sessionTicketLifetime ) * 1000;
+
+	auto ticket = payload + sessionTicketMac( payload );
+	const auto secret = sessionTicketSecret( ticket );
+
+	// the secret never is transferred in plain text but encrypted for the client's public key
+	// or masked with a key the client has transferred encrypted or with the previous ticket secret
+	QByteArray encryptedSecret;
+	if( client->authType() == RfbVeyonAuth::KeyFile )
+	{
+		auto publicKey = client->publicKey();
+		if( publicKey.canEncrypt() )
+		{
+			encryptedSecret = publicKey.encrypt( CryptoCore::SecureArray( secret ),
+												 CryptoCore::DefaultEncryptionAlgorithm ).toByteArray();
+		}
+	}
+	else if( client->sessionTicketKey().isEmpty() == false )
+	{
+		encryptedSecret = CryptoCore::maskData( secret, ticket, client->sessionTicketKey() );
+	}
+
+	if( encryptedSecret.isEmpty() )
+	{
+		// an empty ticket makes the client fall back to full authentication next time
+		ticket.clear();
+	}
+
+	return VariantArrayMessage( ioDevice ).write( ticket ).write( m_sessionTicketLifetime ).write( encryptedSecret ).send();
+}
+
+
+
+QByteArray ServerAuthenticationManager::sessionTicketMac( const QByteArray& payload ) const
+{
+	return QMessageAuthenticationCode::hash( payload, m_sessionTicketKey, QCryptographicHash::Sha256 );
+}
+
+
+
+QByteArray ServerAuthenticationManager::sessionTicketSecret( const QByteArray& ticket ) const
+{
+	return QMessageAuthenticationCode::hash( ticket, m_sessionTicketSecretKey, QCryptographicHash::Sha256 );
+}
+
+
+
+bool ServerAuthenticationManager::isEqualMac( const QByteArray& mac, const QByteArray& expectedMac )
+{
+	if( mac.size() != expectedMac.size() )
+	{
+		return false;
+	}
+
+	// compare in constant time
+	char difference = 0;
+	for( int i = 0; i < mac.size(); ++i )
+	{
+		difference |= char( mac[i] ^ expectedMac[i] );
+	}
+
+	return difference == 0;
+}
+
+
+
+CryptoCore::PublicKey ServerAuthenticationManager::loadPublicKey( const QString& publicKeyPath )
+{
+	// avoid reading and parsing the key file for every single connection but
+	// reload it whenever it has been changed on disk
+	const QFileInfo fileInfo( publicKeyPath );
+
+	const auto it = m_publicKeys.constFind( publicKeyPath );
+	if( it != m_publicKeys.constEnd() &&
+		it->lastModified == fileInfo.lastModified() &&
+		it->size == fileInfo.size() )
+	{
+		return it->key;
+	}
+
+	CryptoCore::PublicKey publicKey( publicKeyPath );
+	if( publicKey.isNull() )
+	{
+		m_publicKeys.remove( publicKeyPath );
+	}
+	else
+	{
+		m_publicKeys[publicKeyPath] = { publicKey, fileInfo.lastModified(), fileInfo.size() };
+	}
+
+	return publicKey;
+}
@@ -24,12 +24,15 @@
 
 #pragma once
 
+#include <QDateTime>
 #include <QMutex>
 #include <QStringList>
 
 #include "RfbVeyonAuth.h"
+#include "RsaKeyPool.h"
 #include "VncServerClient.h"
 
+class QIODevice;
 class VariantArrayMessage;
 
 class ServerAuthenticationManager : public QObject
@@ -54,8 +57,37 @@ Q_SIGNALS:
 	void finished( VncServerClient* client );
 
 private:
+	static constexpr int LogonKeyPoolSize = 4;
+	static constexpr int SessionTicketIdSize = 16;
+	static constexpr int SessionTicketMacSize = 32;
+	static constexpr int MaximumSessionTicketSize = 4096;
+
 	VncServerClient::AuthState performKeyAuthentication( VncServerClient* client, VariantArrayMessage& message );
 	VncServerClient::AuthState performLogonAuthentication( VncServerClient* client, VariantArrayMessage& message );
 	VncServerClient::AuthState performTokenAuthentication( VncServerClient* client, VariantArrayMessage& message );
+	VncServerClient::AuthState performSessionTicketAuthentication( VncServerClient* client, VariantArrayMessage& message );
+
+	bool sendSessionTicket( VncServerClient* client, QIODevice* ioDevice );
+	QByteArray sessionTicketMac( const QByteArray& payload ) const;
+	QByteArray sessionTicketSecret( const QByteArray& ticket ) const;
+	static bool isEqualMac( const QByteArray& mac, const QByteArray& expectedMac );
+
+	CryptoCore::PublicKey loadPublicKey( const QString& publicKeyPath );
+
+	struct CachedPublicKey
+	{
+		CryptoCore::PublicKey key{};
+		QDateTime lastModified{};
+		qint64 size{0};
+	};
+
+	QHash<QString, CachedPublicKey> m_publicKeys{};
+
+	const int m_sessionTicketLifetime;
+	const QByteArray m_sessionTicketKey;
+	const QByteArray m_sessionTicketSecretKey;
+	QHash<QByteArray, qint64> m_consumedSessionTickets{};
+
+	RsaKeyPool m_logonKeyPool;
 
 } ;
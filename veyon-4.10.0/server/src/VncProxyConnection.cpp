@@ -25,7 +25,7 @@
 #include <QBuffer>
 #include <QHostAddress>
 #include <QTcpSocket>
-#include <QTimer>
+#include <QThread>
 
 #include "VncClientProtocol.h"
 #include "VncProxyConnection.h"
@@ -39,14 +39,24 @@ VncProxyConnection::VncProxyConnection( QTcpSocket* clientSocket,
 	m_proxyClientSocket( clientSocket ),
 	m_vncServerSocket( new QTcpSocket( this ) ),
 	m_rfbClientToServerMessageSizes( {
-		{ rfbFramebufferUpdateRequest, sz_rfbFramebufferUpdateRequestMsg },
 		{ rfbKeyEvent, sz_rfbKeyEventMsg },
 		{ rfbPointerEvent, sz_rfbPointerEventMsg },
 		{ rfbXvp, sz_rfbXvpMsg },
 		} )
 {
+	// use timers owned by this object instead of QTimer::singleShot() so pending
+	// retries follow the connection when moving it to a worker thread
+	m_readFromClientTimer.setSingleShot( true );
+	m_readFromClientTimer.setInterval( ProtocolRetryTime );
+	m_readFromServerTimer.setSingleShot( true );
+	m_readFromServerTimer.setInterval( ProtocolRetryTime );
+
+	connect( &m_readFromClientTimer, &QTimer::timeout, this, &VncProxyConnection::readFromClient );
+	connect( &m_readFromServerTimer, &QTimer::timeout, this, &VncProxyConnection::readFromServer );
+
 	connect( m_proxyClientSocket, &QTcpSocket::readyRead, this, &VncProxyConnection::readFromClient );
 	connect( m_vncServerSocket, &QTcpSocket::readyRead, this, &VncProxyConnection::readFromServer );
+	connect( m_proxyClientSocket, &QTcpSocket::bytesWritten, this, &VncProxyConnection::forwardHeldFramebufferUpdateRequest );
 
 	connect( m_vncServerSocket, &QTcpSocket::disconnected, this, &VncProxyConnection::clientConnectionClosed );
 	connect( m_proxyClientSocket, &QTcpSocket::disconnected, this, &VncProxyConnection::serverConnectionClosed );
@@ -73,6 +83,23 @@ void VncProxyConnection::start()
 
 
 
+void VncProxyConnection::moveToWorkerThread( QThread* thread )
+{
+	// the client socket initially is a child of the QTcpServer living in the main thread
+	m_proxyClientSocket->setParent( this );
+
+	setParent( nullptr );
+	moveToThread( thread );
+
+	// process data which has been received in the meantime without further notification
+	QMetaObject::invokeMethod( this, [this]() {
+		readFromClient();
+		readFromServer();
+	}, Qt::QueuedConnection );
+}
+
+
+
 void VncProxyConnection::readFromClient()
 {
 	if( serverProtocol().state() != VncServerProtocol::State::Running )
@@ -88,6 +115,8 @@ void VncProxyConnection::readFromClient()
 	}
 	else if( clientProtocol().state() == VncClientProtocol::Running )
 	{
+		checkEstablished();
+
 		while( receiveClientMessage() )
 		{
 		}
@@ -131,6 +160,8 @@ void VncProxyConnection::readFromServer()
 	}
 	else if( serverProtocol().state() == VncServerProtocol::State::Running )
 	{
+		checkEstablished();
+
 		while( receiveServerMessage() )
 		{
 			Q_EMIT serverMessageProcessed();
@@ -149,11 +180,7 @@ bool VncProxyConnection::forwardDataToClient( qint64 size )
 {
 	if( m_vncServerSocket->bytesAvailable() >= size )
 	{
-		const auto data = m_vncServerSocket->read( size ); // Flawfinder: ignore
-		if( data.size() == size )
-		{
-			return m_proxyClientSocket->write( data ) == size;
-		}
+		return forwardData( m_vncServerSocket, m_proxyClientSocket, size );
 	}
 
 	return false;
@@ -165,28 +192,97 @@ bool VncProxyConnection::forwardDataToServer( qint64 size )
 {
 	if( m_proxyClientSocket->bytesAvailable() >= size )
 	{
-		const auto data = m_proxyClientSocket->read( size ); // Flawfinder: ignore
-		if( data.size() == size )
+		return forwardData( m_proxyClientSocket, m_vncServerSocket, size );
+	}
+
+	return false;
+}
+
+
+
+bool VncProxyConnection::forwardData( QTcpSocket* source, QTcpSocket* destination, qint64 size )
+{
+	// pass data through a buffer which is kept across calls instead of allocating
+	// a new QByteArray for every single message
+	if( m_forwardBuffer.size() < size )
+	{
+		m_forwardBuffer.resize( static_cast<int>( size ) );
+	}
+
+	if( source->read( m_forwardBuffer.data(), size ) == size ) // Flawfinder: ignore
+	{
+		return destination->write( m_forwardBuffer.constData(), size ) == size;
+	}
+
+	return false;
+}
+
+
+
+bool VncProxyConnection::forwardFramebufferUpdateRequest( const QByteArray& message )
+{
+	if( message.size() != sz_rfbFramebufferUpdateRequestMsg )
+	{
+		return false;
+	}
+
+	if( m_proxyClientSocket->bytesToWrite() > FramebufferUpdateHighWatermark )
+	{
+		// client does not keep up with the data sent to it, so hold back the request
+		// until the socket has drained in order to bound memory usage and deliver
+		// current screen content rather than queueing outdated updates
+		const auto heldRequest = reinterpret_cast<const rfbFramebufferUpdateRequestMsg *>( m_heldFramebufferUpdateRequest.constData() );
+		if( m_heldFramebufferUpdateRequest.isEmpty() || heldRequest->incremental )
 		{
-			return m_vncServerSocket->write( data ) == size;
+			m_heldFramebufferUpdateRequest = message;
 		}
+
+		return true;
 	}
 
-	return false;
+	return m_vncServerSocket->write( message ) == message.size();
+}
+
+
+
+void VncProxyConnection::forwardHeldFramebufferUpdateRequest()
+{
+	if( m_heldFramebufferUpdateRequest.isEmpty() == false &&
+		m_proxyClientSocket->bytesToWrite() <= FramebufferUpdateLowWatermark )
+	{
+		m_vncServerSocket->write( std::exchange( m_heldFramebufferUpdateRequest, {} ) );
+	}
 }
 
 
 
 void VncProxyConnection::readFromServerLater()
 {
-	QTimer::singleShot( ProtocolRetryTime, this, &VncProxyConnection::readFromServer );
+	if( m_readFromServerTimer.isActive() == false )
+	{
+		m_readFromServerTimer.start();
+	}
 }
 
 
 
 void VncProxyConnection::readFromClientLater()
 {
-	QTimer::singleShot( ProtocolRetryTime, this, &VncProxyConnection::readFromClient );
+	if( m_readFromClientTimer.isActive() == false )
+	{
+		m_readFromClientTimer.start();
+	}
+}
+
+
+
+void VncProxyConnection::checkEstablished()
+{
+	if( m_established == false )
+	{
+		m_established = true;
+		Q_EMIT established();
+	}
 }
 
 
@@ -221,6 +317,13 @@ bool VncProxyConnection::receiveClientMessage()
 		}
 		break;
 
+	case rfbFramebufferUpdateRequest:
+		if( socket->bytesAvailable() >= sz_rfbFramebufferUpdateRequestMsg )
+		{
+			return forwardFramebufferUpdateRequest( socket->read( sz_rfbFramebufferUpdateRequestMsg ) ); // Flawfinder: ignore
+		}
+		break;
+
 	case rfbSetPixelFormat:
 		if (socket->bytesAvailable() >= sz_rfbSetPixelFormatMsg)
 		{
@@ -258,6 +361,8 @@ bool VncProxyConnection::receiveServerMessage()
 {
 	if( clientProtocol().receiveMessage() )
 	{
+		// the parsed message is handed over as is - QTcpSocket shares the buffer
+		// of large messages instead of copying it into its write buffer
 		m_proxyClientSocket->write( clientProtocol().lastMessage() );
 
 		return true;
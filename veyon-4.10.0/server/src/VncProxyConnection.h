@@ -24,20 +24,31 @@
 
 #pragma once
 
-#include <QObject>
+#include <QTimer>
 
 class QBuffer;
 class QTcpSocket;
+class QThread;
 
 class VncClientProtocol;
 class VncServerProtocol;
 
+/**
+ * \brief Forwards RFB traffic between one client and its own session with the internal VNC server
+ *
+ * Upstream sessions are deliberately not shared between several clients: the encodings
+ * used in practice (Tight, ZRLE, zlib) carry compression state across updates, and every
+ * client negotiates its own pixel format, encodings, scaling and update interval. Fanning
+ * out encoded updates would therefore require re-encoding anyway.
+ */
 class VncProxyConnection : public QObject
 {
 	Q_OBJECT
 public:
 	enum {
-		ProtocolRetryTime = 250
+		ProtocolRetryTime = 250,
+		FramebufferUpdateHighWatermark = 2 * 1024 * 1024,
+		FramebufferUpdateLowWatermark = 256 * 1024
 	};
 
 	VncProxyConnection( QTcpSocket* clientSocket, int vncServerPort, QObject* parent );
@@ -45,6 +56,8 @@ public:
 
 	void start();
 
+	void moveToWorkerThread( QThread* thread );
+
 	QTcpSocket* proxyClientSocket() const
 	{
 		return m_proxyClientSocket;
@@ -55,6 +68,11 @@ public:
 		return m_vncServerSocket;
 	}
 
+	bool isEstablished() const
+	{
+		return m_established;
+	}
+
 protected Q_SLOTS:
 	void readFromClient();
 	void readFromServer();
@@ -62,6 +80,8 @@ protected Q_SLOTS:
 protected:
 	bool forwardDataToClient( qint64 size );
 	bool forwardDataToServer( qint64 size );
+	bool forwardData( QTcpSocket* source, QTcpSocket* destination, qint64 size );
+	bool forwardFramebufferUpdateRequest( const QByteArray& message );
 
 	void readFromServerLater();
 	void readFromClientLater();
@@ -73,6 +93,9 @@ protected:
 	virtual VncServerProtocol& serverProtocol() = 0;
 
 private:
+	void checkEstablished();
+	void forwardHeldFramebufferUpdateRequest();
+
 	const int m_vncServerPort;
 
 	QTcpSocket* m_proxyClientSocket;
@@ -80,7 +103,16 @@ private:
 
 	const QMap<int, int> m_rfbClientToServerMessageSizes;
 
+	QByteArray m_forwardBuffer{};
+	QByteArray m_heldFramebufferUpdateRequest{};
+
+	QTimer m_readFromClientTimer{this};
+	QTimer m_readFromServerTimer{this};
+
+	bool m_established{false};
+
 Q_SIGNALS:
+	void established();
 	void clientConnectionClosed();
 	void serverConnectionClosed();
 	void serverMessageProcessed();
@@ -24,7 +24,9 @@
 
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <QThread>
 
+#include "VeyonConfiguration.h"
 #include "VeyonCore.h"
 #include "VncProxyServer.h"
 #include "VncProxyConnection.h"
@@ -68,6 +70,18 @@ bool VncProxyServer::start( int vncServerPort, const Password& vncServerPassword
 		return false;
 	}
 
+	// established connections optionally get distributed across worker threads so
+	// that framebuffer streams do not congest the main event loop
+	const auto workerThreadCount = VeyonCore::config().vncProxyWorkerThreadCount();
+	for( int i = 0; i < workerThreadCount; ++i )
+	{
+		auto thread = new QThread( this );
+		thread->setObjectName( QStringLiteral("VncProxyWorker-%1").arg( i ) );
+		thread->start();
+
+		m_workerThreads.append( thread );
+	}
+
 	vDebug() << "started on port" << m_listenPort;
 	return true;
 }
@@ -78,11 +92,27 @@ void VncProxyServer::stop()
 {
 	for( auto connection : std::as_const( m_connections ) )
 	{
-		delete connection;
+		if( connection->thread() == thread() )
+		{
+			delete connection;
+		}
+		else
+		{
+			connection->deleteLater();
+		}
 	}
 
 	m_connections.clear();
 
+	for( auto workerThread : std::as_const( m_workerThreads ) )
+	{
+		workerThread->quit();
+		workerThread->wait();
+		delete workerThread;
+	}
+
+	m_workerThreads.clear();
+
 	delete m_server;
 	m_server = nullptr;
 }
@@ -109,6 +139,13 @@ void VncProxyServer::acceptConnection()
 	connect( connection, &VncProxyConnection::clientConnectionClosed, this, [=]() { closeConnection( connection ); } );
 	connect( connection, &VncProxyConnection::serverConnectionClosed, this, [=]() { closeConnection( connection ); } );
 
+	if( m_workerThreads.isEmpty() == false )
+	{
+		// let the connection finish its current read before moving it
+		connect( connection, &VncProxyConnection::established, this,
+				 [=]() { moveConnectionToWorkerThread( connection ); }, Qt::QueuedConnection );
+	}
+
 	connection->start();
 
 	m_connections += connection;
@@ -118,7 +155,12 @@ void VncProxyServer::acceptConnection()
 
 void VncProxyServer::closeConnection( VncProxyConnection* connection )
 {
-	m_connections.removeAll( connection );
+	// both sides of the connection may report being closed but the connection
+	// might already have been deleted after the first report
+	if( m_connections.removeAll( connection ) == 0 )
+	{
+		return;
+	}
 
 	Q_EMIT connectionClosed( connection );
 
@@ -127,6 +169,20 @@ void VncProxyServer::closeConnection( VncProxyConnection* connection )
 
 
 
+void VncProxyServer::moveConnectionToWorkerThread( VncProxyConnection* connection )
+{
+	if( m_connections.contains( connection ) == false )
+	{
+		return;
+	}
+
+	connection->moveToWorkerThread( m_workerThreads.at( m_nextWorkerThread ) );
+
+	m_nextWorkerThread = ( m_nextWorkerThread + 1 ) % m_workerThreads.size();
+}
+
+
+
 void VncProxyServer::handleAcceptError( QAbstractSocket::SocketError socketError )
 {
 	vCritical() << "error while accepting connection" << socketError;
@@ -30,6 +30,7 @@
 #include "CryptoCore.h"
 
 class QTcpServer;
+class QThread;
 class VncProxyConnection;
 class VncProxyConnectionFactory;
 
@@ -61,6 +62,7 @@ Q_SIGNALS:
 private:
 	void acceptConnection();
 	void closeConnection( VncProxyConnection* );
+	void moveConnectionToWorkerThread( VncProxyConnection* connection );
 	void handleAcceptError( QAbstractSocket::SocketError socketError );
 
 	int m_vncServerPort;
@@ -71,4 +73,7 @@ private:
 	VncProxyConnectionFactory* m_connectionFactory;
 	VncProxyConnectionList m_connections;
 
+	QVector<QThread *> m_workerThreads{};
+	int m_nextWorkerThread{0};
+
 } ;
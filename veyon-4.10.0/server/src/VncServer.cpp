@@ -138,6 +138,13 @@ VncServer::Password VncServer::password() const
 
 
 
+bool VncServer::supportsFramebufferScaling() const
+{
+	return m_pluginInterface && m_pluginInterface->supportsFramebufferScaling();
+}
+
+
+
 void VncServer::run()
 {
 	if( m_pluginInterface )
@@ -47,6 +47,8 @@ public:
 
 	Password password() const;
 
+	bool supportsFramebufferScaling() const;
+
 private:
 	void run() override;
 
@@ -0,0 +1,15 @@
+#include <QBuffer>
+
+#include "FeatureMessage.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const char *data, size_t size)
+{
+	QBuffer buffer;
+	buffer.open(QIODevice::ReadWrite);
+	buffer.write(QByteArray::fromRawData(data, size));
+	buffer.seek(0);
+
+	FeatureMessage().receiveCompact(&buffer);
+
+	return 0;
+}
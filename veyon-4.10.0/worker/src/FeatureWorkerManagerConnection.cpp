@@ -23,34 +23,34 @@
  */
 
 #include <QCoreApplication>
-#include <QHostAddress>
 
 #include "FeatureManager.h"
+#include "FeatureWorkerManager.h"
 #include "FeatureWorkerManagerConnection.h"
-#include "VeyonConfiguration.h"
 
 
 FeatureWorkerManagerConnection::FeatureWorkerManagerConnection( VeyonWorkerInterface& worker,
 																Feature::Uid featureUid,
+																const QString& poolWorkerToken,
 																QObject* parent ) :
 	QObject( parent ),
 	m_worker( worker ),
-	m_port(VeyonCore::config().featureWorkerManagerPort() + VeyonCore::sessionId()),
 	m_socket( this ),
-	m_featureUid( featureUid )
+	m_featureUid( featureUid ),
+	m_poolWorkerToken( poolWorkerToken )
 {
 	connect( &m_connectTimer, &QTimer::timeout, this, &FeatureWorkerManagerConnection::tryConnection );
 
-	connect( &m_socket, &QTcpSocket::connected,
+	connect( &m_socket, &FeatureWorkerManager::Socket::connected,
 			 this, &FeatureWorkerManagerConnection::sendInitMessage );
 
-	connect(&m_socket, &QTcpSocket::disconnected, this,
+	connect(&m_socket, &FeatureWorkerManager::Socket::disconnected, this,
 			[=]() {
 		vDebug() << "lost connection to FeatureWorkerManager – exiting";
 		QCoreApplication::instance()->exit(0);
 	}, Qt::QueuedConnection);
 
-	connect( &m_socket, &QTcpSocket::readyRead,
+	connect( &m_socket, &FeatureWorkerManager::Socket::readyRead,
 			 this, &FeatureWorkerManagerConnection::receiveMessage );
 
 	tryConnection();
@@ -69,11 +69,17 @@ bool FeatureWorkerManagerConnection::sendMessage( const FeatureMessage& message
 
 void FeatureWorkerManagerConnection::tryConnection()
 {
-	if( m_socket.state() != QTcpSocket::ConnectedState )
+	if( m_socket.state() != FeatureWorkerManager::Socket::ConnectedState )
 	{
-		vDebug() << "connecting to FeatureWorkerManager at port" << m_port;
+#ifdef Q_OS_WIN
+		vDebug() << "connecting to FeatureWorkerManager at port" << FeatureWorkerManager::serverPort();
 
-		m_socket.connectToHost(QHostAddress::LocalHost, m_port);
+		m_socket.connectToHost(QHostAddress::LocalHost, FeatureWorkerManager::serverPort());
+#else
+		vDebug() << "connecting to FeatureWorkerManager at" << FeatureWorkerManager::serverName();
+
+		m_socket.connectToServer(FeatureWorkerManager::serverName());
+#endif
 		m_connectTimer.start(ConnectTimeout);
 	}
 }
@@ -86,6 +92,15 @@ void FeatureWorkerManagerConnection::sendInitMessage()
 
 	m_connectTimer.stop();
 
+	if( m_featureUid.isNull() )
+	{
+		// announce as pool worker waiting for a feature to be assigned
+		FeatureMessage(m_featureUid, FeatureMessage::Command::Init)
+			.addArgument(FeatureWorkerManager::PoolWorkerArgument::Token, m_poolWorkerToken)
+			.sendPlain(&m_socket);
+		return;
+	}
+
 	FeatureMessage(m_featureUid, FeatureMessage::Command::Init).sendPlain(&m_socket);
 }
 
@@ -97,9 +112,22 @@ void FeatureWorkerManagerConnection::receiveMessage()
 
 	while( featureMessage.isReadyForReceive( &m_socket ) )
 	{
-		if( featureMessage.receive( &m_socket ) )
+		if( featureMessage.receive( &m_socket ) == false )
 		{
-			VeyonCore::featureManager().handleFeatureMessage( m_worker, featureMessage );
+			continue;
 		}
+
+		if( m_featureUid.isNull() )
+		{
+			if( featureMessage.command() == FeatureMessage::Command::Init &&
+				featureMessage.featureUid().isNull() == false )
+			{
+				m_featureUid = featureMessage.featureUid();
+				Q_EMIT featureAssigned( m_featureUid );
+			}
+			continue;
+		}
+
+		VeyonCore::featureManager().handleFeatureMessage( m_worker, featureMessage );
 	}
 }
@@ -24,10 +24,10 @@
 
 #pragma once
 
-#include <QTcpSocket>
 #include <QTimer>
 
 #include "Feature.h"
+#include "FeatureWorkerManager.h"
 
 class FeatureManager;
 class FeatureMessage;
@@ -39,11 +39,15 @@ class FeatureWorkerManagerConnection : public QObject
 public:
 	FeatureWorkerManagerConnection( VeyonWorkerInterface& worker,
 									Feature::Uid featureUid,
+									const QString& poolWorkerToken,
 									QObject* parent = nullptr );
 
 
 	bool sendMessage( const FeatureMessage& message );
 
+Q_SIGNALS:
+	void featureAssigned( Feature::Uid featureUid );
+
 private:
 	static constexpr auto ConnectTimeout = 3000;
 
@@ -52,9 +56,9 @@ private:
 	void receiveMessage();
 
 	VeyonWorkerInterface& m_worker;
-	const int m_port;
-	QTcpSocket m_socket;
+	FeatureWorkerManager::Socket m_socket;
 	Feature::Uid m_featureUid;
+	const QString m_poolWorkerToken;
 	QTimer m_connectTimer{this};
 
 } ;
@@ -30,35 +30,26 @@
 #include "VeyonWorker.h"
 
 
-VeyonWorker::VeyonWorker( QUuid featureUid, QObject* parent ) :
+VeyonWorker::VeyonWorker( QUuid featureUid, const QString& poolWorkerToken, QObject* parent ) :
 	QObject( parent ),
 	m_core( QCoreApplication::instance(),
 			VeyonCore::Component::Worker,
-			QStringLiteral("FeatureWorker-") + featureUid.toString(QUuid::WithoutBraces))
+			QStringLiteral("FeatureWorker-") + ( featureUid.isNull() ? QStringLiteral("Pool") : featureUid.toString(QUuid::WithoutBraces) ) )
 {
-	const Feature* workerFeature = nullptr;
-
-	for( const auto& feature : VeyonCore::featureManager().features() )
+	if( featureUid.isNull() == false )
 	{
-		if( feature.uid() == featureUid )
-		{
-			workerFeature = &feature;
-		}
+		initFeature( featureUid );
 	}
 
-	if( workerFeature == nullptr )
-	{
-		qFatal( "Could not find specified feature" );
-	}
+	m_workerManagerConnection = new FeatureWorkerManagerConnection(*this, featureUid, poolWorkerToken);
 
-	if( m_core.config().disabledFeatures().contains( featureUid.toString() ) )
+	if( featureUid.isNull() )
 	{
-		qFatal( "Specified feature is disabled by configuration!" );
-	}
+		connect( m_workerManagerConnection, &FeatureWorkerManagerConnection::featureAssigned,
+				 this, &VeyonWorker::initFeature );
 
-	m_workerManagerConnection = new FeatureWorkerManagerConnection(*this, featureUid);
-
-	vInfo() << "Running worker for feature" << workerFeature->name();
+		vInfo() << "Running pool worker";
+	}
 }
 
 
@@ -80,3 +71,30 @@ bool VeyonWorker::sendFeatureMessageReply( const FeatureMessage& reply )
 	return m_workerManagerConnection &&
 			m_workerManagerConnection->sendMessage( reply );
 }
+
+
+
+void VeyonWorker::initFeature( QUuid featureUid )
+{
+	const Feature* workerFeature = nullptr;
+
+	for( const auto& feature : VeyonCore::featureManager().features() )
+	{
+		if( feature.uid() == featureUid )
+		{
+			workerFeature = &feature;
+		}
+	}
+
+	if( workerFeature == nullptr )
+	{
+		qFatal( "Could not find specified feature" );
+	}
+
+	if( m_core.config().disabledFeatures().contains( featureUid.toString() ) )
+	{
+		qFatal( "Specified feature is disabled by configuration!" );
+	}
+
+	vInfo() << "Running worker for feature" << workerFeature->name();
+}
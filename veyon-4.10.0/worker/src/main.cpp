@@ -23,9 +23,11 @@
  */
 
 #include <QApplication>
+#include <QFile>
 #include <QIcon>
 
 #include "Feature.h"
+#include "FeatureWorkerManager.h"
 #include "VeyonWorker.h"
 
 
@@ -43,13 +45,39 @@ int main( int argc, char **argv )
 		qFatal( "Not enough arguments (feature)" );
 	}
 
-	const auto featureUid = Feature::Uid{arguments[1]};
-	if( featureUid.isNull() )
+	// pooled workers get their feature assigned by the FeatureWorkerManager later
+	const auto isPoolWorker = arguments[1] == FeatureWorkerManager::poolWorkerArgument();
+
+	// system workers receive their token through stdin as the command line is visible to all users
+	QString poolWorkerToken;
+	if( isPoolWorker )
+	{
+		if( arguments.count() >= 3 )
+		{
+			poolWorkerToken = arguments[2];
+		}
+		else
+		{
+			QFile standardInput;
+			if( standardInput.open( stdin, QFile::ReadOnly ) )
+			{
+				poolWorkerToken = QString::fromUtf8( standardInput.readLine().trimmed() ); // Flawfinder: ignore
+			}
+		}
+
+		if( poolWorkerToken.isEmpty() )
+		{
+			qFatal( "No pool worker token given" );
+		}
+	}
+
+	const auto featureUid = isPoolWorker ? Feature::Uid{} : Feature::Uid{arguments[1]};
+	if( featureUid.isNull() && isPoolWorker == false )
 	{
 		qFatal( "Invalid feature UID given" );
 	}
 
-	VeyonWorker worker( featureUid );
+	VeyonWorker worker( featureUid, poolWorkerToken );
 
 	return worker.core().exec();
 }